@@ -275,6 +275,29 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// magick_image_ping_blob
+Rcpp::IntegerVector magick_image_ping_blob(Rcpp::RawVector x);
+RcppExport SEXP _magick_magick_image_ping_blob(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::RawVector >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_ping_blob(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_image_ping
+Rcpp::DataFrame magick_image_ping(Rcpp::CharacterVector paths, bool largest);
+RcppExport SEXP _magick_magick_image_ping(SEXP pathsSEXP, SEXP largestSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type paths(pathsSEXP);
+    Rcpp::traits::input_parameter< bool >::type largest(largestSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_ping(paths, largest));
+    return rcpp_result_gen;
+END_RCPP
+}
 // magick_image_as_raster
 Rcpp::CharacterVector magick_image_as_raster(Rcpp::RawVector data);
 RcppExport SEXP _magick_magick_image_as_raster(SEXP dataSEXP) {
@@ -286,6 +309,27 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// magick_image_augment
+XPtrImage magick_image_augment(XPtrImage input, size_t n, int seed, std::string crop, double flip, double flop, Rcpp::NumericVector rotate, Rcpp::NumericVector brightness, Rcpp::NumericVector saturation, Rcpp::NumericVector hue, Rcpp::NumericVector noise);
+RcppExport SEXP _magick_magick_image_augment(SEXP inputSEXP, SEXP nSEXP, SEXP seedSEXP, SEXP cropSEXP, SEXP flipSEXP, SEXP flopSEXP, SEXP rotateSEXP, SEXP brightnessSEXP, SEXP saturationSEXP, SEXP hueSEXP, SEXP noiseSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrImage >::type input(inputSEXP);
+    Rcpp::traits::input_parameter< size_t >::type n(nSEXP);
+    Rcpp::traits::input_parameter< int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< std::string >::type crop(cropSEXP);
+    Rcpp::traits::input_parameter< double >::type flip(flipSEXP);
+    Rcpp::traits::input_parameter< double >::type flop(flopSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type rotate(rotateSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type brightness(brightnessSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type saturation(saturationSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type hue(hueSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type noise(noiseSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_augment(input, n, seed, crop, flip, flop, rotate, brightness, saturation, hue, noise));
+    return rcpp_result_gen;
+END_RCPP
+}
 // magick_threads
 int magick_threads(size_t i);
 RcppExport SEXP _magick_magick_threads(SEXP iSEXP) {
@@ -356,6 +400,18 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// magick_image_mutable
+XPtrImage magick_image_mutable(XPtrImage image, bool enable);
+RcppExport SEXP _magick_magick_image_mutable(SEXP imageSEXP, SEXP enableSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrImage >::type image(imageSEXP);
+    Rcpp::traits::input_parameter< bool >::type enable(enableSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_mutable(image, enable));
+    return rcpp_result_gen;
+END_RCPP
+}
 // magick_image_rev
 XPtrImage magick_image_rev(XPtrImage input);
 RcppExport SEXP _magick_magick_image_rev(SEXP inputSEXP) {
@@ -1005,9 +1061,36 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// magick_image_readarray
+XPtrImage magick_image_readarray(Rcpp::List arrays, std::string layout);
+RcppExport SEXP _magick_magick_image_readarray(SEXP arraysSEXP, SEXP layoutSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type arrays(arraysSEXP);
+    Rcpp::traits::input_parameter< std::string >::type layout(layoutSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_readarray(arrays, layout));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_image_set_data
+XPtrImage magick_image_set_data(XPtrImage input, SEXP x, std::string layout, size_t frame, Rcpp::CharacterVector region);
+RcppExport SEXP _magick_magick_image_set_data(SEXP inputSEXP, SEXP xSEXP, SEXP layoutSEXP, SEXP frameSEXP, SEXP regionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrImage >::type input(inputSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    Rcpp::traits::input_parameter< std::string >::type layout(layoutSEXP);
+    Rcpp::traits::input_parameter< size_t >::type frame(frameSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type region(regionSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_set_data(input, x, layout, frame, region));
+    return rcpp_result_gen;
+END_RCPP
+}
 // magick_image_readbin
-XPtrImage magick_image_readbin(Rcpp::RawVector x, Rcpp::CharacterVector density, Rcpp::IntegerVector depth, bool strip, Rcpp::CharacterVector defines);
-RcppExport SEXP _magick_magick_image_readbin(SEXP xSEXP, SEXP densitySEXP, SEXP depthSEXP, SEXP stripSEXP, SEXP definesSEXP) {
+XPtrImage magick_image_readbin(Rcpp::RawVector x, Rcpp::CharacterVector density, Rcpp::IntegerVector depth, bool strip, Rcpp::CharacterVector defines, Rcpp::CharacterVector size, Rcpp::CharacterVector region, Rcpp::IntegerVector frames, bool coalesce);
+RcppExport SEXP _magick_magick_image_readbin(SEXP xSEXP, SEXP densitySEXP, SEXP depthSEXP, SEXP stripSEXP, SEXP definesSEXP, SEXP sizeSEXP, SEXP regionSEXP, SEXP framesSEXP, SEXP coalesceSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -1016,13 +1099,17 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type depth(depthSEXP);
     Rcpp::traits::input_parameter< bool >::type strip(stripSEXP);
     Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type defines(definesSEXP);
-    rcpp_result_gen = Rcpp::wrap(magick_image_readbin(x, density, depth, strip, defines));
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type size(sizeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type region(regionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type frames(framesSEXP);
+    Rcpp::traits::input_parameter< bool >::type coalesce(coalesceSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_readbin(x, density, depth, strip, defines, size, region, frames, coalesce));
     return rcpp_result_gen;
 END_RCPP
 }
 // magick_image_readpath
-XPtrImage magick_image_readpath(Rcpp::CharacterVector paths, Rcpp::CharacterVector density, Rcpp::IntegerVector depth, bool strip, Rcpp::CharacterVector defines);
-RcppExport SEXP _magick_magick_image_readpath(SEXP pathsSEXP, SEXP densitySEXP, SEXP depthSEXP, SEXP stripSEXP, SEXP definesSEXP) {
+XPtrImage magick_image_readpath(Rcpp::CharacterVector paths, Rcpp::CharacterVector density, Rcpp::IntegerVector depth, bool strip, Rcpp::CharacterVector defines, Rcpp::CharacterVector size, Rcpp::CharacterVector region, Rcpp::IntegerVector frames, bool coalesce);
+RcppExport SEXP _magick_magick_image_readpath(SEXP pathsSEXP, SEXP densitySEXP, SEXP depthSEXP, SEXP stripSEXP, SEXP definesSEXP, SEXP sizeSEXP, SEXP regionSEXP, SEXP framesSEXP, SEXP coalesceSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -1031,7 +1118,71 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type depth(depthSEXP);
     Rcpp::traits::input_parameter< bool >::type strip(stripSEXP);
     Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type defines(definesSEXP);
-    rcpp_result_gen = Rcpp::wrap(magick_image_readpath(paths, density, depth, strip, defines));
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type size(sizeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type region(regionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type frames(framesSEXP);
+    Rcpp::traits::input_parameter< bool >::type coalesce(coalesceSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_readpath(paths, density, depth, strip, defines, size, region, frames, coalesce));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_image_open
+XPtrImage magick_image_open(Rcpp::CharacterVector paths, Rcpp::CharacterVector density);
+RcppExport SEXP _magick_magick_image_open(SEXP pathsSEXP, SEXP densitySEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type paths(pathsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type density(densitySEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_open(paths, density));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_image_materialize
+XPtrImage magick_image_materialize(XPtrImage input, double budget);
+RcppExport SEXP _magick_magick_image_materialize(SEXP inputSEXP, SEXP budgetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrImage >::type input(inputSEXP);
+    Rcpp::traits::input_parameter< double >::type budget(budgetSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_materialize(input, budget));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_stream_open
+XPtrStream magick_stream_open(std::string path, Rcpp::CharacterVector density, bool coalesce);
+RcppExport SEXP _magick_magick_stream_open(SEXP pathSEXP, SEXP densitySEXP, SEXP coalesceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type density(densitySEXP);
+    Rcpp::traits::input_parameter< bool >::type coalesce(coalesceSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_stream_open(path, density, coalesce));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_stream_next
+XPtrImage magick_stream_next(XPtrStream stream, size_t n);
+RcppExport SEXP _magick_magick_stream_next(SEXP streamSEXP, SEXP nSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrStream >::type stream(streamSEXP);
+    Rcpp::traits::input_parameter< size_t >::type n(nSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_stream_next(stream, n));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_stream_info
+Rcpp::List magick_stream_info(XPtrStream stream);
+RcppExport SEXP _magick_magick_stream_info(SEXP streamSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrStream >::type stream(streamSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_stream_info(stream));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -1063,16 +1214,53 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// magick_image_write_file
+void magick_image_write_file(XPtrImage input, std::string path, Rcpp::CharacterVector format, Rcpp::IntegerVector quality, Rcpp::IntegerVector depth, Rcpp::CharacterVector density, Rcpp::CharacterVector comment, Rcpp::CharacterVector compression);
+RcppExport SEXP _magick_magick_image_write_file(SEXP inputSEXP, SEXP pathSEXP, SEXP formatSEXP, SEXP qualitySEXP, SEXP depthSEXP, SEXP densitySEXP, SEXP commentSEXP, SEXP compressionSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrImage >::type input(inputSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type format(formatSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type quality(qualitySEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type depth(depthSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type density(densitySEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type comment(commentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type compression(compressionSEXP);
+    magick_image_write_file(input, path, format, quality, depth, density, comment, compression);
+    return R_NilValue;
+END_RCPP
+}
+// magick_image_write_files
+Rcpp::CharacterVector magick_image_write_files(XPtrImage input, Rcpp::CharacterVector paths, Rcpp::CharacterVector format, Rcpp::IntegerVector quality, Rcpp::IntegerVector depth, Rcpp::CharacterVector density, Rcpp::CharacterVector comment, Rcpp::CharacterVector compression);
+RcppExport SEXP _magick_magick_image_write_files(SEXP inputSEXP, SEXP pathsSEXP, SEXP formatSEXP, SEXP qualitySEXP, SEXP depthSEXP, SEXP densitySEXP, SEXP commentSEXP, SEXP compressionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrImage >::type input(inputSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type paths(pathsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type format(formatSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type quality(qualitySEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type depth(depthSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type density(densitySEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type comment(commentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type compression(compressionSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_write_files(input, paths, format, quality, depth, density, comment, compression));
+    return rcpp_result_gen;
+END_RCPP
+}
 // magick_image_write_frame
-Rcpp::RawVector magick_image_write_frame(XPtrImage input, const char * format, size_t i);
-RcppExport SEXP _magick_magick_image_write_frame(SEXP inputSEXP, SEXP formatSEXP, SEXP iSEXP) {
+Rcpp::RawVector magick_image_write_frame(XPtrImage input, const char * format, size_t i, bool planar, std::string region);
+RcppExport SEXP _magick_magick_image_write_frame(SEXP inputSEXP, SEXP formatSEXP, SEXP iSEXP, SEXP planarSEXP, SEXP regionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< XPtrImage >::type input(inputSEXP);
     Rcpp::traits::input_parameter< const char * >::type format(formatSEXP);
     Rcpp::traits::input_parameter< size_t >::type i(iSEXP);
-    rcpp_result_gen = Rcpp::wrap(magick_image_write_frame(input, format, i));
+    Rcpp::traits::input_parameter< bool >::type planar(planarSEXP);
+    Rcpp::traits::input_parameter< std::string >::type region(regionSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_write_frame(input, format, i, planar, region));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -1087,6 +1275,23 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// magick_image_tensor
+SEXP magick_image_tensor(XPtrImage input, std::string size, std::string layout, std::string channels, std::string dtype, Rcpp::NumericVector mean, Rcpp::NumericVector sd);
+RcppExport SEXP _magick_magick_image_tensor(SEXP inputSEXP, SEXP sizeSEXP, SEXP layoutSEXP, SEXP channelsSEXP, SEXP dtypeSEXP, SEXP meanSEXP, SEXP sdSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrImage >::type input(inputSEXP);
+    Rcpp::traits::input_parameter< std::string >::type size(sizeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type layout(layoutSEXP);
+    Rcpp::traits::input_parameter< std::string >::type channels(channelsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type dtype(dtypeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type mean(meanSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type sd(sdSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_tensor(input, size, layout, channels, dtype, mean, sd));
+    return rcpp_result_gen;
+END_RCPP
+}
 // magick_image_display
 XPtrImage magick_image_display(XPtrImage image, bool animate);
 RcppExport SEXP _magick_magick_image_display(SEXP imageSEXP, SEXP animateSEXP) {
@@ -1176,6 +1381,50 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// magick_image_lazy_eval
+XPtrImage magick_image_lazy_eval(XPtrImage image);
+RcppExport SEXP _magick_magick_image_lazy_eval(SEXP imageSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrImage >::type image(imageSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_lazy_eval(image));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_limit_exists
+bool magick_limit_exists(std::string name);
+RcppExport SEXP _magick_magick_limit_exists(SEXP nameSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type name(nameSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_limit_exists(name));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_limit_get
+double magick_limit_get(std::string name);
+RcppExport SEXP _magick_magick_limit_get(SEXP nameSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type name(nameSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_limit_get(name));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_limit_set
+void magick_limit_set(std::string name, std::string value);
+RcppExport SEXP _magick_magick_limit_set(SEXP nameSEXP, SEXP valueSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type name(nameSEXP);
+    Rcpp::traits::input_parameter< std::string >::type value(valueSEXP);
+    magick_limit_set(name, value);
+    return R_NilValue;
+END_RCPP
+}
 // list_options
 Rcpp::CharacterVector list_options(const char * str);
 RcppExport SEXP _magick_list_options(SEXP strSEXP) {
@@ -1228,6 +1477,68 @@ BEGIN_RCPP
     return R_NilValue;
 END_RCPP
 }
+// magick_calibrate_internal
+Rcpp::List magick_calibrate_internal();
+RcppExport SEXP _magick_magick_calibrate_internal() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(magick_calibrate_internal());
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_image_pixel_at
+Rcpp::NumericMatrix magick_image_pixel_at(XPtrImage input, Rcpp::NumericVector x, Rcpp::NumericVector y, size_t frame, const char * interpolate);
+RcppExport SEXP _magick_magick_image_pixel_at(SEXP inputSEXP, SEXP xSEXP, SEXP ySEXP, SEXP frameSEXP, SEXP interpolateSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrImage >::type input(inputSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type x(xSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type y(ySEXP);
+    Rcpp::traits::input_parameter< size_t >::type frame(frameSEXP);
+    Rcpp::traits::input_parameter< const char * >::type interpolate(interpolateSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_pixel_at(input, x, y, frame, interpolate));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_image_set_spans
+XPtrImage magick_image_set_spans(XPtrImage input, Rcpp::IntegerVector x, Rcpp::IntegerVector y, Rcpp::IntegerVector len, Rcpp::CharacterVector colors, Rcpp::IntegerVector col, size_t frame, bool blend);
+RcppExport SEXP _magick_magick_image_set_spans(SEXP inputSEXP, SEXP xSEXP, SEXP ySEXP, SEXP lenSEXP, SEXP colorsSEXP, SEXP colSEXP, SEXP frameSEXP, SEXP blendSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrImage >::type input(inputSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type x(xSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type y(ySEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type len(lenSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type colors(colorsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type col(colSEXP);
+    Rcpp::traits::input_parameter< size_t >::type frame(frameSEXP);
+    Rcpp::traits::input_parameter< bool >::type blend(blendSEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_set_spans(input, x, y, len, colors, col, frame, blend));
+    return rcpp_result_gen;
+END_RCPP
+}
+// magick_image_patches
+SEXP magick_image_patches(XPtrImage input, std::string size, std::string stride, bool padding, std::string channels, Rcpp::CharacterVector background, double fuzz_percent, double max_background, bool array);
+RcppExport SEXP _magick_magick_image_patches(SEXP inputSEXP, SEXP sizeSEXP, SEXP strideSEXP, SEXP paddingSEXP, SEXP channelsSEXP, SEXP backgroundSEXP, SEXP fuzz_percentSEXP, SEXP max_backgroundSEXP, SEXP arraySEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< XPtrImage >::type input(inputSEXP);
+    Rcpp::traits::input_parameter< std::string >::type size(sizeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type stride(strideSEXP);
+    Rcpp::traits::input_parameter< bool >::type padding(paddingSEXP);
+    Rcpp::traits::input_parameter< std::string >::type channels(channelsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type background(backgroundSEXP);
+    Rcpp::traits::input_parameter< double >::type fuzz_percent(fuzz_percentSEXP);
+    Rcpp::traits::input_parameter< double >::type max_background(max_backgroundSEXP);
+    Rcpp::traits::input_parameter< bool >::type array(arraySEXP);
+    rcpp_result_gen = Rcpp::wrap(magick_image_patches(input, size, stride, padding, channels, background, fuzz_percent, max_background, array));
+    return rcpp_result_gen;
+END_RCPP
+}
 // magick_image_properties
 Rcpp::DataFrame magick_image_properties(XPtrImage input);
 RcppExport SEXP _magick_magick_image_properties(SEXP inputSEXP) {
@@ -1655,13 +1966,17 @@ static const R_CallMethodDef CallEntries[] = {
     {"_magick_magick_attr_quantize", (DL_FUNC) &_magick_magick_attr_quantize, 2},
     {"_magick_magick_attr_density", (DL_FUNC) &_magick_magick_attr_density, 2},
     {"_magick_magick_image_info", (DL_FUNC) &_magick_magick_image_info, 1},
+    {"_magick_magick_image_ping_blob", (DL_FUNC) &_magick_magick_image_ping_blob, 1},
+    {"_magick_magick_image_ping", (DL_FUNC) &_magick_magick_image_ping, 2},
     {"_magick_magick_image_as_raster", (DL_FUNC) &_magick_magick_image_as_raster, 1},
+    {"_magick_magick_image_augment", (DL_FUNC) &_magick_magick_image_augment, 11},
     {"_magick_magick_threads", (DL_FUNC) &_magick_magick_threads, 1},
     {"_magick_magick_image_dead", (DL_FUNC) &_magick_magick_image_dead, 1},
     {"_magick_magick_image_length", (DL_FUNC) &_magick_magick_image_length, 1},
     {"_magick_create", (DL_FUNC) &_magick_create, 1},
     {"_magick_magick_image_blank", (DL_FUNC) &_magick_magick_image_blank, 5},
     {"_magick_copy", (DL_FUNC) &_magick_copy, 1},
+    {"_magick_magick_image_mutable", (DL_FUNC) &_magick_magick_image_mutable, 2},
     {"_magick_magick_image_rev", (DL_FUNC) &_magick_magick_image_rev, 1},
     {"_magick_magick_image_join", (DL_FUNC) &_magick_magick_image_join, 1},
     {"_magick_magick_image_subset", (DL_FUNC) &_magick_magick_image_subset, 2},
@@ -1714,12 +2029,22 @@ static const R_CallMethodDef CallEntries[] = {
     {"_magick_magick_image_readbitmap_raster2", (DL_FUNC) &_magick_magick_image_readbitmap_raster2, 1},
     {"_magick_magick_image_readbitmap_raw", (DL_FUNC) &_magick_magick_image_readbitmap_raw, 1},
     {"_magick_magick_image_readbitmap_double", (DL_FUNC) &_magick_magick_image_readbitmap_double, 1},
-    {"_magick_magick_image_readbin", (DL_FUNC) &_magick_magick_image_readbin, 5},
-    {"_magick_magick_image_readpath", (DL_FUNC) &_magick_magick_image_readpath, 5},
+    {"_magick_magick_image_readarray", (DL_FUNC) &_magick_magick_image_readarray, 2},
+    {"_magick_magick_image_set_data", (DL_FUNC) &_magick_magick_image_set_data, 5},
+    {"_magick_magick_image_readbin", (DL_FUNC) &_magick_magick_image_readbin, 9},
+    {"_magick_magick_image_readpath", (DL_FUNC) &_magick_magick_image_readpath, 9},
+    {"_magick_magick_image_open", (DL_FUNC) &_magick_magick_image_open, 2},
+    {"_magick_magick_image_materialize", (DL_FUNC) &_magick_magick_image_materialize, 2},
+    {"_magick_magick_stream_open", (DL_FUNC) &_magick_magick_stream_open, 3},
+    {"_magick_magick_stream_next", (DL_FUNC) &_magick_magick_stream_next, 2},
+    {"_magick_magick_stream_info", (DL_FUNC) &_magick_magick_stream_info, 1},
     {"_magick_magick_image_read_list", (DL_FUNC) &_magick_magick_image_read_list, 1},
     {"_magick_magick_image_write", (DL_FUNC) &_magick_magick_image_write, 7},
-    {"_magick_magick_image_write_frame", (DL_FUNC) &_magick_magick_image_write_frame, 3},
+    {"_magick_magick_image_write_file", (DL_FUNC) &_magick_magick_image_write_file, 8},
+    {"_magick_magick_image_write_files", (DL_FUNC) &_magick_magick_image_write_files, 8},
+    {"_magick_magick_image_write_frame", (DL_FUNC) &_magick_magick_image_write_frame, 5},
     {"_magick_magick_image_write_integer", (DL_FUNC) &_magick_magick_image_write_integer, 1},
+    {"_magick_magick_image_tensor", (DL_FUNC) &_magick_magick_image_tensor, 7},
     {"_magick_magick_image_display", (DL_FUNC) &_magick_magick_image_display, 2},
     {"_magick_magick_image_fft", (DL_FUNC) &_magick_magick_image_fft, 1},
     {"_magick_magick_image_montage", (DL_FUNC) &_magick_magick_image_montage, 6},
@@ -1727,11 +2052,19 @@ static const R_CallMethodDef CallEntries[] = {
     {"_magick_magick_image_separate", (DL_FUNC) &_magick_magick_image_separate, 2},
     {"_magick_magick_image_combine", (DL_FUNC) &_magick_magick_image_combine, 3},
     {"_magick_magick_image_set_define", (DL_FUNC) &_magick_magick_image_set_define, 4},
+    {"_magick_magick_image_lazy_eval", (DL_FUNC) &_magick_magick_image_lazy_eval, 1},
+    {"_magick_magick_limit_exists", (DL_FUNC) &_magick_magick_limit_exists, 1},
+    {"_magick_magick_limit_get", (DL_FUNC) &_magick_magick_limit_get, 1},
+    {"_magick_magick_limit_set", (DL_FUNC) &_magick_magick_limit_set, 2},
     {"_magick_list_options", (DL_FUNC) &_magick_list_options, 1},
     {"_magick_list_font_info", (DL_FUNC) &_magick_list_font_info, 0},
     {"_magick_dump_option_list", (DL_FUNC) &_magick_dump_option_list, 1},
     {"_magick_set_magick_tempdir", (DL_FUNC) &_magick_set_magick_tempdir, 1},
     {"_magick_set_magick_seed", (DL_FUNC) &_magick_set_magick_seed, 1},
+    {"_magick_magick_calibrate_internal", (DL_FUNC) &_magick_magick_calibrate_internal, 0},
+    {"_magick_magick_image_pixel_at", (DL_FUNC) &_magick_magick_image_pixel_at, 5},
+    {"_magick_magick_image_set_spans", (DL_FUNC) &_magick_magick_image_set_spans, 8},
+    {"_magick_magick_image_patches", (DL_FUNC) &_magick_magick_image_patches, 9},
     {"_magick_magick_image_properties", (DL_FUNC) &_magick_magick_image_properties, 1},
     {"_magick_magick_image_scale", (DL_FUNC) &_magick_magick_image_scale, 2},
     {"_magick_magick_image_sample", (DL_FUNC) &_magick_magick_image_sample, 2},
@@ -206,39 +206,195 @@ Rcpp::DataFrame magick_image_info( XPtrImage input){
   );
 }
 
+typedef struct {
+  std::string format, colorspace, density, orientation, error;
+  size_t width, height, frames, filesize;
+} PingInfo;
+
+static std::string mnemonic(MagickCore::CommandOption type, ssize_t val){
+  const char * str = MagickCore::CommandOptionToMnemonic(type, val);
+  return str ? str : "";
+}
+
+/* Width and height of the frame with the most pixels */
+static Magick::Geometry largest_frame(MagickCore::Image * images){
+  Magick::Geometry out(0, 0);
+  for(MagickCore::Image * next = images; next; next = MagickCore::GetNextImageInList(next)){
+    if((double) next->columns * next->rows > (double) out.width() * out.height())
+      out = Magick::Geometry(next->columns, next->rows);
+  }
+  return out;
+}
+
+static std::string ping_error(MagickCore::ExceptionInfo *exception){
+  std::string error = exception->severity >= MagickCore::ErrorException && exception->reason ?
+    std::string(exception->reason) : std::string("Failed to read image headers");
+  if(exception->severity >= MagickCore::ErrorException && exception->description)
+    error += std::string(" (") + exception->description + ")";
+  return error;
+}
+
+static Magick::ReadOptions ping_options(){
+  Magick::ReadOptions opts = Magick::ReadOptions();
+#if MagickLibVersion >= 0x690
+  opts.quiet(1);
+#endif
+  set_time_monitor(opts.imageInfo());
+  return opts;
+}
+
+/* Reads the headers of an image file without decoding pixels. This does not
+ * call the R API such that it can run in parallel. The width and height are
+ * those of the first frame, or of the largest frame if 'largest' is set. */
+static PingInfo ping_path(std::string path, bool largest){
+  PingInfo info = PingInfo();
+  Magick::ReadOptions opts = ping_options();
+  MagickCore::CopyMagickString(opts.imageInfo()->filename, path.c_str(), sizeof(opts.imageInfo()->filename));
+  MagickCore::ExceptionInfo *exception = MagickCore::AcquireExceptionInfo();
+  MagickCore::Image *images = MagickCore::PingImage(opts.imageInfo(), exception);
+  if(images == NULL){
+    info.error = ping_error(exception);
+  } else {
+    info.frames = MagickCore::GetImageListLength(images);
+    Magick::Geometry geom = largest ? largest_frame(images) : Magick::Geometry(images->columns, images->rows);
+    Frame frame(MagickCore::RemoveFirstImageFromList(&images));
+    MagickCore::DestroyImageList(images);
+    info.format = std::string(frame.magick());
+    info.width = geom.width();
+    info.height = geom.height();
+    info.colorspace = mnemonic(MagickCore::MagickColorspaceOptions, frame.colorSpace());
+    info.orientation = mnemonic(MagickCore::MagickOrientationOptions, frame.orientation());
+    info.density = std::string(frame.density());
+    info.filesize = frame.fileSize();
+  }
+  MagickCore::DestroyExceptionInfo(exception);
+  return info;
+}
+
+/* Width and height of the largest frame in an image blob, from its headers */
+// [[Rcpp::export]]
+Rcpp::IntegerVector magick_image_ping_blob(Rcpp::RawVector x){
+  Magick::ReadOptions opts = ping_options();
+  MagickCore::ExceptionInfo *exception = MagickCore::AcquireExceptionInfo();
+  MagickCore::Image *images = MagickCore::PingBlob(opts.imageInfo(), x.begin(), x.length(), exception);
+  if(images == NULL){
+    std::string error = ping_error(exception);
+    MagickCore::DestroyExceptionInfo(exception);
+    throw std::runtime_error(error);
+  }
+  MagickCore::DestroyExceptionInfo(exception);
+  Magick::Geometry geom = largest_frame(images);
+  MagickCore::DestroyImageList(images);
+  return Rcpp::IntegerVector::create(geom.width(), geom.height());
+}
+
+// [[Rcpp::export]]
+Rcpp::DataFrame magick_image_ping(Rcpp::CharacterVector paths, bool largest = false){
+  int len = paths.size();
+  std::vector<std::string> input(len);
+  for(int i = 0; i < len; i++)
+    input[i] = std::string(paths.at(i));
+  std::vector<PingInfo> results(len);
+  parallel_for(len, [&](size_t i){
+    results[i] = ping_path(input[i], largest);
+  });
+  Rcpp::CharacterVector format(len);
+  Rcpp::IntegerVector width(len);
+  Rcpp::IntegerVector height(len);
+  Rcpp::CharacterVector colorspace(len);
+  Rcpp::IntegerVector frames(len);
+  Rcpp::CharacterVector density(len);
+  Rcpp::CharacterVector orientation(len);
+  Rcpp::NumericVector filesize(len);
+  Rcpp::CharacterVector error(len);
+  for(int i = 0; i < len; i++){
+    PingInfo & info = results[i];
+    if(info.error.length()){
+      format[i] = colorspace[i] = density[i] = orientation[i] = NA_STRING;
+      width[i] = height[i] = frames[i] = NA_INTEGER;
+      filesize[i] = NA_REAL;
+      error[i] = info.error;
+    } else {
+      format[i] = info.format;
+      width[i] = info.width;
+      height[i] = info.height;
+      colorspace[i] = info.colorspace;
+      frames[i] = info.frames;
+      density[i] = info.density;
+      orientation[i] = info.orientation;
+      filesize[i] = info.filesize;
+      error[i] = NA_STRING;
+    }
+  }
+  return Rcpp::DataFrame::create(
+    Rcpp::_["path"] = paths,
+    Rcpp::_["format"] = format,
+    Rcpp::_["width"] = width,
+    Rcpp::_["height"] = height,
+    Rcpp::_["colorspace"] = colorspace,
+    Rcpp::_["frames"] = frames,
+    Rcpp::_["density"] = density,
+    Rcpp::_["orientation"] = orientation,
+    Rcpp::_["filesize"] = filesize,
+    Rcpp::_["error"] = error,
+    Rcpp::_["stringsAsFactors"] = false
+  );
+}
+
+/* Most images have far fewer colors than pixels, so colors are looked up in an
+ * open-addressing hash table of packed RGBA values, which saves building the hex
+ * string and the global CHARSXP cache lookup of Rf_mkCharLen() for each pixel.
+ * The table stops growing when it is half full, after which new colors are
+ * converted one by one as before. */
 // [[Rcpp::export]]
 Rcpp::CharacterVector magick_image_as_raster( Rcpp::RawVector data ){
   Rcpp::IntegerVector dim = data.attr("dim") ;
   int w = dim[1], h = dim[2] ;
-  static std::string sixteen( "0123456789abcdef" ) ;
-  Rcpp::String transparent( "transparent" ) ;
+  static const char sixteen[] = "0123456789abcdef" ;
+  char hexbyte[256][2] ;
+  for(int i = 0; i < 256; i++){
+    hexbyte[i][0] = sixteen[i >> 4] ;
+    hexbyte[i][1] = sixteen[i & 0x0F] ;
+  }
 
   Rcpp::CharacterMatrix out(h,w) ;
+  Rcpp::Shield<SEXP> transparent( Rf_mkChar("transparent") ) ;
+  const size_t size = 1 << 16, mask = size - 1 ;
+  std::vector<uint32_t> keys(size) ;
+  std::vector<SEXP> values(size, (SEXP) NULL) ;
+  size_t used = 0 ;
   Rbyte* p = data.begin() ;
-  std::string buf( "#00000000" ) ;
-
-  for(int i=0; i<h; i++){
-    int k = i*w ;
-    for(int j=0; j<w; j++, p+= 4, k++){
-
-      if( p[3] ){
-        Rbyte red = p[0], green = p[1], blue = p[2], alpha = p[3];
+  char buf[9] = {'#'} ;
 
-        buf[1] = sixteen[ red >> 4 ] ;
-        buf[2] = sixteen[ red & 0x0F ] ;
-        buf[3] = sixteen[ green >> 4 ] ;
-        buf[4] = sixteen[ green & 0x0F ] ;
-        buf[5] = sixteen[ blue >> 4 ] ;
-        buf[6] = sixteen[ blue & 0x0F ] ;
-        buf[7] = sixteen[ alpha >> 4 ] ;
-        buf[8] = sixteen[ alpha & 0x0F ] ;
-
-        out[k] = Rf_mkCharLen( buf.c_str(), 9) ;
-
-      } else {
-        out[k] = transparent ;
+  size_t len = (size_t) w * h ;
+  for(size_t k = 0; k < len; k++, p += 4){
+    if( !p[3] ){
+      SET_STRING_ELT(out, k, transparent) ;
+      continue ;
+    }
+    uint32_t key = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24) ;
+    size_t slot = ((key * 2654435761u) >> 16) & mask ;
+    SEXP str = NULL ;
+    for(; values[slot] != NULL; slot = (slot + 1) & mask){
+      if(keys[slot] == key){
+        str = values[slot] ;
+        break ;
+      }
+    }
+    if(str == NULL){
+      memcpy(buf + 1, hexbyte[p[0]], 2) ;
+      memcpy(buf + 3, hexbyte[p[1]], 2) ;
+      memcpy(buf + 5, hexbyte[p[2]], 2) ;
+      memcpy(buf + 7, hexbyte[p[3]], 2) ;
+      str = Rf_mkCharLen(buf, 9) ;
+      if(used < size / 2){
+        keys[slot] = key ;
+        values[slot] = str ;
+        used++ ;
       }
     }
+    // Strings in the table are protected by 'out'
+    SET_STRING_ELT(out, k, str) ;
   }
 
   out.attr("class") = "raster" ;
@@ -0,0 +1,148 @@
+/* Randomized variants of frames for data augmentation. Every variant is made
+ * by a separate task with its own random number stream, seeded from the seed,
+ * the frame and the variant number, so the result does not depend on the
+ * number of threads or the order in which the tasks run. Noise is generated
+ * from the same stream rather than with the ImageMagick random generator,
+ * which is shared between threads.
+ */
+
+#include "magick_types.h"
+#include <random>
+
+typedef std::mt19937_64 Rng;
+
+/* Uniform value in [0, 1) from the top 53 bits, which unlike the standard
+ * distributions gives the same values with every C++ library */
+static double uniform(Rng & rng){
+  return (rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* A value drawn uniformly from a range c(min, max), a fixed value, or the
+ * default if the option is not set. A number is consumed in each case. */
+static double draw(Rng & rng, const std::vector<double> & range, double fallback){
+  double u = uniform(rng);
+  if(!range.size())
+    return fallback;
+  return range.size() == 1 ? range[0] : range[0] + u * (range[1] - range[0]);
+}
+
+static bool chance(Rng & rng, double p){
+  return uniform(rng) < p;
+}
+
+/* Adds gaussian noise with a standard deviation relative to the quantum range
+ * to the color channels. Gray frames get the same noise on each channel. */
+static void add_noise(Frame & frame, double sd, Rng & rng){
+  std::normal_distribution<double> noise(0, sd * QuantumRange);
+  frame.modifyImage();
+  MagickCore::Image * image = frame.image();
+  MagickCore::ExceptionInfo * exception = MagickCore::AcquireExceptionInfo();
+  MagickCore::CacheView * view = acquire_authentic_view(image, exception);
+#if MagickLibVersion < 0x700
+  bool gray = frame.colorSpace() == Magick::GRAYColorspace;
+#endif
+  for(ssize_t y = 0; y < (ssize_t) image->rows; y++){
+#if MagickLibVersion >= 0x700
+    MagickCore::Quantum * q = MagickCore::GetCacheViewAuthenticPixels(view, 0, y, image->columns, 1, exception);
+    if(q == NULL)
+      break;
+    for(size_t x = 0; x < image->columns; x++){
+      for(size_t i = 0; i < MagickCore::GetPixelChannels(image); i++){
+        MagickCore::PixelChannel channel = MagickCore::GetPixelChannelChannel(image, i);
+        MagickCore::PixelTrait traits = MagickCore::GetPixelChannelTraits(image, channel);
+        if(channel != MagickCore::AlphaPixelChannel && (traits & MagickCore::UpdatePixelTrait))
+          q[i] = MagickCore::ClampToQuantum(q[i] + noise(rng));
+      }
+      q += MagickCore::GetPixelChannels(image);
+    }
+#else
+    MagickCore::PixelPacket * q = MagickCore::GetCacheViewAuthenticPixels(view, 0, y, image->columns, 1, exception);
+    if(q == NULL)
+      break;
+    for(size_t x = 0; x < image->columns; x++, q++){
+      double r = noise(rng);
+      SetPixelRed(q, MagickCore::ClampToQuantum(GetPixelRed(q) + r));
+      SetPixelGreen(q, MagickCore::ClampToQuantum(GetPixelGreen(q) + (gray ? r : noise(rng))));
+      SetPixelBlue(q, MagickCore::ClampToQuantum(GetPixelBlue(q) + (gray ? r : noise(rng))));
+    }
+#endif
+    MagickCore::SyncCacheViewAuthenticPixels(view, exception);
+  }
+  MagickCore::DestroyCacheView(view);
+  MagickCore::DestroyExceptionInfo(exception);
+}
+
+typedef struct {
+  std::string crop;
+  double flip, flop;
+  std::vector<double> rotate, brightness, saturation, hue, noise;
+} AugmentSpec;
+
+/* Applies one random draw of the spec to a frame. Every parameter is drawn,
+ * also if its option is not set, such that each option gets the same values
+ * for a given seed regardless of which other options are enabled. */
+static void augment_frame(Frame & frame, const AugmentSpec & spec, Rng & rng){
+  double angle = draw(rng, spec.rotate, 0);
+  double u = uniform(rng);
+  double v = uniform(rng);
+  bool flip = chance(rng, spec.flip);
+  bool flop = chance(rng, spec.flop);
+  double brightness = draw(rng, spec.brightness, 100);
+  double saturation = draw(rng, spec.saturation, 100);
+  double hue = draw(rng, spec.hue, 100);
+  double sd = draw(rng, spec.noise, 0);
+  if(angle != 0){
+    // Rotates about the center and keeps the size, filling with the virtual pixel method
+    frame.distort(MagickCore::ScaleRotateTranslateDistortion, 1, &angle, false);
+  }
+  if(spec.crop.length()){
+    Magick::Geometry size = Geom(spec.crop.c_str());
+    size_t width = std::min(size.width(), frame.columns());
+    size_t height = std::min(size.height(), frame.rows());
+    size_t x = (size_t) (u * (frame.columns() - width + 1));
+    size_t y = (size_t) (v * (frame.rows() - height + 1));
+    frame.crop(Geom(width, height, std::min(x, frame.columns() - width), std::min(y, frame.rows() - height)));
+    frame.myRepage();
+  }
+  if(flip)
+    frame.flip();
+  if(flop)
+    frame.flop();
+  if(brightness != 100 || saturation != 100 || hue != 100)
+    frame.modulate(brightness, saturation, hue);
+  if(sd > 0)
+    add_noise(frame, sd, rng);
+}
+
+static std::vector<double> range(Rcpp::NumericVector x){
+  if(x.size() > 2 || (x.size() == 2 && x[0] > x[1]))
+    throw std::runtime_error("Augmentation ranges must be a single value or c(min, max)");
+  return std::vector<double>(x.begin(), x.end());
+}
+
+// [[Rcpp::export]]
+XPtrImage magick_image_augment(XPtrImage input, size_t n, int seed, std::string crop, double flip,
+                               double flop, Rcpp::NumericVector rotate, Rcpp::NumericVector brightness,
+                               Rcpp::NumericVector saturation, Rcpp::NumericVector hue,
+                               Rcpp::NumericVector noise){
+  AugmentSpec spec = {crop, flip, flop, range(rotate), range(brightness), range(saturation),
+                      range(hue), range(noise)};
+  if(crop.length()){
+    Magick::Geometry size = Geom(crop.c_str());
+    if(!size.width() || !size.height())
+      throw std::runtime_error("Crop size must have both a width and height, for example 224x224");
+  }
+  Image & frames = *input;
+  Image output(frames.size() * n);
+  parallel_for(output.size(), [&](size_t k){
+    size_t i = k / n;
+    std::seed_seq seq{(uint32_t) seed, (uint32_t) i, (uint32_t) (k % n)};
+    Rng rng(seq);
+    Frame frame = frames[i];
+    augment_frame(frame, spec, rng);
+    output[k] = frame;
+  });
+  XPtrImage image = create();
+  image->swap(output);
+  return image;
+}
@@ -86,6 +86,24 @@ XPtrImage copy (XPtrImage image){
   return ptr;
 }
 
+// Images created by image_mutate() are modified in place rather than copied
+XPtrImage modify (XPtrImage image){
+  if(Rf_inherits(image, "magick-image") && !Rf_isNull(Rf_getAttrib(image, Rf_install("mutable"))))
+    return image;
+  return copy(image);
+}
+
+// [[Rcpp::export]]
+XPtrImage magick_image_mutable(XPtrImage image, bool enable){
+  if(!enable){
+    image.attr("mutable") = R_NilValue;
+    return image;
+  }
+  XPtrImage output = copy(image);
+  output.attr("mutable") = true;
+  return output;
+}
+
 // [[Rcpp::export]]
 XPtrImage magick_image_rev(XPtrImage input){
   XPtrImage output = create(input->size());
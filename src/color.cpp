@@ -7,28 +7,28 @@
 
 // [[Rcpp::export]]
 XPtrImage magick_image_contrast( XPtrImage input, size_t sharpen){
-  XPtrImage output = copy(input);
-  for_each(output->begin(), output->end(), Magick::contrastImage(sharpen));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::contrastImage(sharpen));
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_normalize( XPtrImage input){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::normalizeImage());
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::normalizeImage());
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_modulate( XPtrImage input, double brightness, double saturation, double hue){
-  XPtrImage output = copy(input);
-  for_each(output->begin(), output->end(), Magick::modulateImage(brightness, saturation, hue));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::modulateImage(brightness, saturation, hue));
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_map( XPtrImage input, XPtrImage map_image, bool dither){
-  XPtrImage output = copy(input);
+  XPtrImage output = map_image.get() == input.get() ? copy(input) : modify(input);
   if(map_image->size())
     mapImages(output->begin(), output->end(), map_image->front(), dither);
   return output;
@@ -36,43 +36,43 @@ XPtrImage magick_image_map( XPtrImage input, XPtrImage map_image, bool dither){
 
 // [[Rcpp::export]]
 XPtrImage magick_image_channel( XPtrImage input, const char * channel){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::channelImage(Channel(channel)));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::channelImage(Channel(channel)), COST_LIGHT);
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_colorize( XPtrImage input, const size_t opacity, const char * color){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::colorizeImage(opacity, Color(color)));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::colorizeImage(opacity, Color(color)), COST_LIGHT);
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_enhance( XPtrImage input){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::enhanceImage());
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::enhanceImage());
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_equalize( XPtrImage input){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::equalizeImage());
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::equalizeImage());
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_median( XPtrImage input, double radius){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::myMedianImage(radius));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::myMedianImage(radius), COST_HEAVY);
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_quantize( XPtrImage input, size_t max, Rcpp::CharacterVector space,
                                  Rcpp::LogicalVector dither, Rcpp::IntegerVector depth){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   if(space.size())
     for_each ( output->begin(), output->end(), Magick::quantizeColorSpaceImage(ColorSpace(space.at(0))));
   if(dither.size())
@@ -82,13 +82,13 @@ XPtrImage magick_image_quantize( XPtrImage input, size_t max, Rcpp::CharacterVec
 
   //quantize!
   for_each ( output->begin(), output->end(), Magick::quantizeColorsImage(max));
-  for_each ( output->begin(), output->end(), Magick::quantizeImage(false));
+  parallel_for_each(output->begin(), output->end(), Magick::quantizeImage(false), COST_HEAVY);
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_ordered_dither( XPtrImage input, std::string threshold_map){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
 #if MagickLibVersion >= 0x689
   for(size_t i = 0; i < output->size(); i++)
     output->at(i).orderedDither(threshold_map);
@@ -101,25 +101,26 @@ XPtrImage magick_image_ordered_dither( XPtrImage input, std::string threshold_ma
 // [[Rcpp::export]]
 XPtrImage magick_image_transparent( XPtrImage input, const char * color, double fuzz_percent){
   double fuzz = fuzz_pct_to_abs(fuzz_percent);
-  XPtrImage output = copy(input);
+  double oldfuzz = input->size() ? input->front().colorFuzz() : 0;
+  XPtrImage output = modify(input);
   if(fuzz != 0)
     for_each ( output->begin(), output->end(), Magick::colorFuzzImage(fuzz));
-  for_each ( output->begin(), output->end(), Magick::transparentImage(Color(color)));
+  parallel_for_each(output->begin(), output->end(), Magick::transparentImage(Color(color)), COST_LIGHT);
   if(fuzz != 0)
-    for_each ( output->begin(), output->end(), Magick::colorFuzzImage(input->front().colorFuzz()));
+    for_each ( output->begin(), output->end(), Magick::colorFuzzImage(oldfuzz));
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_background( XPtrImage input, const char * color){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   for_each (output->begin(), output->end(), Magick::backgroundColorImage(Color(color)));
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_virtual_pixel( XPtrImage input, const char * method ) {
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   for(size_t i = 0; i < output->size(); i++) {
     output->at(i).virtualPixelMethod(VirtualPixelValue(method));
   }
@@ -134,8 +135,8 @@ XPtrImage magick_image_lat( XPtrImage input, const char * geomstr){
   double offset =  geom.xOff();
   if(geom.percent())
     offset = fuzz_pct_to_abs(offset);
-  XPtrImage output = copy(input);
-  for_each (output->begin(), output->end(), Magick::adaptiveThresholdImage(width, height, offset));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::adaptiveThresholdImage(width, height, offset), COST_HEAVY);
   return output;
 }
 
@@ -144,15 +145,17 @@ XPtrImage magick_image_lat( XPtrImage input, const char * geomstr){
  */
 // [[Rcpp::export]]
 XPtrImage magick_image_threshold_black( XPtrImage input,  const std::string threshold, Rcpp::CharacterVector channel){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
 #if MagickLibVersion >= 0x687
   if(channel.length()){
     Magick::ChannelType chan = Channel(std::string(channel.at(0)).c_str());
-    for(size_t i = 0; i < output->size(); i++)
-      output->at(i).blackThresholdChannel(chan, threshold);
+    parallel_for_each(output->begin(), output->end(), [&](Frame & frame){
+      frame.blackThresholdChannel(chan, threshold);
+    }, COST_LIGHT);
   } else {
-    for(size_t i = 0; i < output->size(); i++)
-      output->at(i).blackThreshold(threshold);
+    parallel_for_each(output->begin(), output->end(), [&](Frame & frame){
+      frame.blackThreshold(threshold);
+    }, COST_LIGHT);
   }
 #else
   Rcpp::warning("ImageMagick too old to support whiteThreshold (requires >= 6.8.7)");
@@ -162,15 +165,17 @@ XPtrImage magick_image_threshold_black( XPtrImage input,  const std::string thre
 
 // [[Rcpp::export]]
 XPtrImage magick_image_threshold_white( XPtrImage input,  const std::string threshold, Rcpp::CharacterVector channel){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
 #if MagickLibVersion >= 0x687
   if(channel.length()){
     Magick::ChannelType chan = Channel(std::string(channel.at(0)).c_str());
-    for(size_t i = 0; i < output->size(); i++)
-      output->at(i).whiteThresholdChannel(chan, threshold);
+    parallel_for_each(output->begin(), output->end(), [&](Frame & frame){
+      frame.whiteThresholdChannel(chan, threshold);
+    }, COST_LIGHT);
   } else {
-    for(size_t i = 0; i < output->size(); i++)
-      output->at(i).whiteThreshold(threshold);
+    parallel_for_each(output->begin(), output->end(), [&](Frame & frame){
+      frame.whiteThreshold(threshold);
+    }, COST_LIGHT);
   }
 #else
   Rcpp::warning("ImageMagick too old to support whiteThreshold (requires >= 6.8.7)");
@@ -181,15 +186,16 @@ XPtrImage magick_image_threshold_white( XPtrImage input,  const std::string thre
 // [[Rcpp::export]]
 XPtrImage magick_image_level( XPtrImage input, double black_pct, double white_pct, double mid_point,
                               Rcpp::CharacterVector channel){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   double black_point = fuzz_pct_to_abs(black_pct);
   double white_point = fuzz_pct_to_abs(white_pct);
   if(channel.length()){
     Magick::ChannelType chan = Channel(std::string(channel.at(0)).c_str());
-    for(size_t i = 0; i < output->size(); i++)
-      output->at(i).levelChannel(chan, black_point, white_point, mid_point);
+    parallel_for_each(output->begin(), output->end(), [=](Frame & frame){
+      frame.levelChannel(chan, black_point, white_point, mid_point);
+    }, COST_LIGHT);
   } else {
-    for_each(output->begin(), output->end(), Magick::levelImage(black_point, white_point, mid_point));
+    parallel_for_each(output->begin(), output->end(), Magick::levelImage(black_point, white_point, mid_point), COST_LIGHT);
   }
   return output;
 }
@@ -17,7 +17,7 @@ XPtrImage magick_image_composite( XPtrImage input, XPtrImage composite_image,
                                   const char * composite, Rcpp::CharacterVector args){
   if(composite_image->size() == 0)
     throw std::runtime_error("Invalid composite_image");
-  XPtrImage output = copy(input);
+  XPtrImage output = composite_image.get() == input.get() ? copy(input) : modify(input);
   if(args.size() && std::string(args.at(0)).length()){
 #if MagickLibVersion >= 0x687
     for (Iter it = output->begin(); it != output->end(); ++it)
@@ -50,7 +50,7 @@ XPtrImage magick_image_composite( XPtrImage input, XPtrImage composite_image,
 // [[Rcpp::export]]
 XPtrImage magick_image_border( XPtrImage input, Rcpp::CharacterVector color, Rcpp::CharacterVector geometry,
                                Rcpp::CharacterVector composite){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   for_each ( output->begin(), output->end(), Magick::composeImage(Composite(composite.at(0))));
   if(color.size())
     for_each ( output->begin(), output->end(), Magick::borderColorImage(Color(color.at(0))));
@@ -61,7 +61,7 @@ XPtrImage magick_image_border( XPtrImage input, Rcpp::CharacterVector color, Rcp
 
 // [[Rcpp::export]]
 XPtrImage magick_image_frame( XPtrImage input, Rcpp::CharacterVector color, Rcpp::CharacterVector geometry){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   if(color.size())
     for_each ( output->begin(), output->end(), Magick::matteColorImage(Color(color.at(0))));
   if(geometry.size())
@@ -71,7 +71,7 @@ XPtrImage magick_image_frame( XPtrImage input, Rcpp::CharacterVector color, Rcpp
 
 // [[Rcpp::export]]
 XPtrImage magick_image_shadow_mask( XPtrImage input, const char * geomstr){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
 #if MagickLibVersion >= 0x675
   Magick::Geometry geom = Geom(geomstr);
   const double opacity = geom.width();
@@ -87,33 +87,39 @@ XPtrImage magick_image_shadow_mask( XPtrImage input, const char * geomstr){
 
 // [[Rcpp::export]]
 XPtrImage magick_image_shade( XPtrImage input, double azimuth = 30, double elevation = 30, bool color = false){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   for_each ( output->begin(), output->end(), Magick::shadeImage(azimuth, elevation, color));
   return output;
 }
 
 // The C++ crop() API doesn't work well, see https://github.com/ImageMagick/ImageMagick/issues/1642
 
+void frame_crop(Frame & frame, Magick::Geometry region, const char * gravity){
+  if(gravity && strlen(gravity))
+    region = apply_geom_gravity(frame, region, Gravity(gravity));
+  if(region.percent()){
+    MagickCore::ExceptionInfo *exception = MagickCore::AcquireExceptionInfo();
+    MagickCore::Image *newImage = MagickCore::CropImageToTiles(frame.constImage(), std::string(region).c_str(), exception);
+#if MagickLibVersion >= 0x690
+    Magick::throwException(exception);
+#endif
+    exception=MagickCore::DestroyExceptionInfo(exception);
+    frame.replaceImage(newImage);
+  } else {
+    frame.crop(region);
+  }
+}
+
 // [[Rcpp::export]]
 XPtrImage magick_image_crop( XPtrImage input, Rcpp::CharacterVector geometry,
                              Rcpp::CharacterVector gravity, bool repage){
-  XPtrImage output = copy(input);
-  for(size_t i = 0; i < output->size(); i++){
-    Magick::Geometry region(geometry.size() ? Geom(geometry.at(0)) : input->front().size());
-    if(gravity.size())
-      region = apply_geom_gravity(output->at(i), region, Gravity(gravity.at(0)));
-    if(region.percent()){
-      MagickCore::ExceptionInfo *exception = MagickCore::AcquireExceptionInfo();
-      MagickCore::Image *newImage = MagickCore::CropImageToTiles(output->at(i).constImage(), std::string(region).c_str(), exception);
-  #if MagickLibVersion >= 0x690
-      Magick::throwException(exception);
-  #endif
-      exception=MagickCore::DestroyExceptionInfo(exception);
-      output->at(i).replaceImage(newImage);
-    } else {
-      output->at(i).crop(region);
-    }
-  }
+  XPtrImage output = modify(input);
+  std::string grav = gravity.size() ? std::string(gravity.at(0)) : std::string();
+  if(!output->size())
+    return output;
+  Magick::Geometry region(geometry.size() ? Geom(geometry.at(0)) : input->front().size());
+  for(size_t i = 0; i < output->size(); i++)
+    frame_crop(output->at(i), region, grav.c_str());
   if(repage)
     for_each ( output->begin(), output->end(), Magick::pageImage(Magick::Geometry()));
   return output;
@@ -122,7 +128,7 @@ XPtrImage magick_image_crop( XPtrImage input, Rcpp::CharacterVector geometry,
 // [[Rcpp::export]]
 XPtrImage magick_image_extent( XPtrImage input, Rcpp::CharacterVector geometry,
                                Rcpp::CharacterVector gravity, Rcpp::CharacterVector color){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   for(size_t i = 0; i < output->size(); i++){
     output->at(i).extent(Geom(geometry.at(0)), Color(color.at(0)), Gravity(gravity.at(0)));
   }
@@ -4,6 +4,8 @@
  */
 
 #include "magick_types.h"
+#include <unordered_map>
+#include <sys/stat.h>
 
 Magick::CompressionType Compression(const char * str){
   ssize_t val = MagickCore::ParseCommandOption( MagickCore::MagickCompressOptions, Magick::MagickFalse, str);
@@ -12,21 +14,27 @@ Magick::CompressionType Compression(const char * str){
   return (Magick::CompressionType) val;
 }
 
-XPtrImage magick_image_bitmap(void * data, Magick::StorageType type, size_t slices, size_t width, size_t height){
-  const char * format;
+static const char * bitmap_map(size_t slices){
   switch ( slices ){ //TODO: K is blackchannel, there should be a 'graychannel' instead? (G = Green!)
-    case 1 : format = "K"; break;
-    case 2 : format = "KA"; break;
-    case 3 : format = "RGB"; break;
-    case 4 : format = "RGBA"; break;
+    case 1 : return "K";
+    case 2 : return "KA";
+    case 3 : return "RGB";
+    case 4 : return "RGBA";
     default: throw std::runtime_error("Invalid number of channels (must be 4 or less)");
   }
-  Frame frame(width, height, format, type , data);
+}
+
+static Frame bitmap_frame(void * data, Magick::StorageType type, size_t slices, size_t width, size_t height){
+  Frame frame(width, height, bitmap_map(slices), type , data);
   if(slices == 1) //Workaround for using 'K' above
     frame.channel(Magick::BlackChannel);
   frame.magick("PNG");
+  return frame;
+}
+
+XPtrImage magick_image_bitmap(void * data, Magick::StorageType type, size_t slices, size_t width, size_t height){
   XPtrImage image = create();
-  image->push_back(frame);
+  image->push_back(bitmap_frame(data, type, slices, width, height));
   return image;
 }
 
@@ -36,20 +44,69 @@ XPtrImage magick_image_readbitmap_native(Rcpp::IntegerMatrix x){
   return magick_image_bitmap(x.begin(), Magick::CharPixel, 4, dims[1], dims[0]);
 }
 
+static int hexval(char c){
+  if(c >= '0' && c <= '9')
+    return c - '0';
+  if(c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if(c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+/* Fast path for "#RRGGBB" and "#RRGGBBAA"; other strings such as color names go
+ * through R_GE_str2col(). Returns false if the string is not a full hex color. */
+static bool parse_hex(const char * str, size_t len, rcolor * out){
+  if(str[0] != '#' || (len != 7 && len != 9))
+    return false;
+  int val[8] = {15, 15, 15, 15, 15, 15, 15, 15};
+  for(size_t i = 1; i < len; i++){
+    if((val[i-1] = hexval(str[i])) < 0)
+      return false;
+  }
+  *out = R_RGBA(val[0] * 16 + val[1], val[2] * 16 + val[3], val[4] * 16 + val[5], val[6] * 16 + val[7]);
+  return true;
+}
+
+/* Raster images tend to repeat the same few colors, and CHARSXPs are unique per
+ * string, so parsed colors are memoized in an open-addressing hash table keyed
+ * on the CHARSXP pointer. The table stops growing when it is half full. */
+static std::vector<rcolor> raster_colors(Rcpp::CharacterMatrix x){
+  std::vector<rcolor> y(x.size());
+  const size_t size = 1 << 16, mask = size - 1;
+  std::vector<SEXP> keys(size, (SEXP) NULL);
+  std::vector<rcolor> values(size);
+  size_t used = 0;
+  for(size_t i = 0; i < y.size(); i++){
+    SEXP str = STRING_ELT(x, i);
+    size_t slot = ((uint32_t) (((uintptr_t) str >> 4) * 2654435761u) >> 16) & mask;
+    while(keys[slot] != NULL && keys[slot] != str)
+      slot = (slot + 1) & mask;
+    if(keys[slot] == str){
+      y[i] = values[slot];
+      continue;
+    }
+    if(str == NA_STRING || !parse_hex(CHAR(str), LENGTH(str), &y[i]))
+      y[i] = R_GE_str2col(CHAR(str));
+    if(used < size / 2){
+      keys[slot] = str;
+      values[slot] = y[i];
+      used++;
+    }
+  }
+  return y;
+}
+
 // [[Rcpp::export]]
 XPtrImage magick_image_readbitmap_raster1(Rcpp::CharacterMatrix x){
-  std::vector<rcolor> y(x.size());
-  for(size_t i = 0; i < y.size(); i++)
-    y[i] = R_GE_str2col(x[i]);
+  std::vector<rcolor> y = raster_colors(x);
   Rcpp::IntegerVector dims(x.attr("dim"));
   return magick_image_bitmap(y.data(), Magick::CharPixel, 4, dims[0], dims[1]);
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_readbitmap_raster2(Rcpp::CharacterMatrix x){
-  std::vector<rcolor> y(x.size());
-  for(size_t i = 0; i < y.size(); i++)
-    y[i] = R_GE_str2col(x[i]);
+  std::vector<rcolor> y = raster_colors(x);
   Rcpp::IntegerVector dims(x.attr("dim"));
   return magick_image_bitmap(y.data(), Magick::CharPixel, 4, dims[1], dims[0]);
 }
@@ -66,11 +123,255 @@ XPtrImage magick_image_readbitmap_double(Rcpp::NumericVector x){
   return magick_image_bitmap(x.begin(), Magick::DoublePixel, dims[0], dims[1], dims[2]);
 }
 
+/* Position of the pixels of a frame within an R array. The layout string gives
+ * the order of the first three dimensions, for example "cwh" for channels x
+ * width x height (interleaved) or "whc" for width x height x channels (planar).
+ * An optional fourth dimension holds the frames. */
+typedef struct {
+  size_t channels, width, height, frames;
+  size_t cstride, xstride, ystride;
+} ArrayLayout;
+
+static ArrayLayout array_layout(SEXP x, const std::string & layout){
+  Rcpp::IntegerVector dims(Rf_getAttrib(x, R_DimSymbol));
+  if(dims.size() != 3 && dims.size() != 4)
+    throw std::runtime_error("Bitmap array must have 3 or 4 dimensions");
+  ArrayLayout out = ArrayLayout();
+  out.frames = dims.size() == 4 ? dims[3] : 1;
+  size_t stride = 1;
+  for(int i = 0; i < 3; i++){
+    switch(layout.at(i)){
+      case 'c': out.channels = dims[i]; out.cstride = stride; break;
+      case 'w': out.width = dims[i]; out.xstride = stride; break;
+      case 'h': out.height = dims[i]; out.ystride = stride; break;
+      default: throw std::runtime_error("Invalid array layout: " + layout);
+    }
+    stride *= dims[i];
+  }
+  if(!out.channels || !out.width || !out.height)
+    throw std::runtime_error("Invalid array layout: " + layout);
+  bitmap_map(out.channels);
+  return out;
+}
+
+static inline void to_pixel(unsigned char & out, Rbyte val){
+  out = val;
+}
+
+static inline void to_pixel(unsigned char & out, int val){
+  out = val < 0 || val == NA_INTEGER ? 0 : val > 255 ? 255 : val;
+}
+
+static inline void to_pixel(double & out, double val){
+  out = val;
+}
+
+/* Copies one frame from an R array into an interleaved row-major buffer */
+template <typename T, typename S>
+static void interleave(const T * in, S * out, const ArrayLayout & a){
+  size_t k = 0;
+  for(size_t y = 0; y < a.height; y++)
+    for(size_t x = 0; x < a.width; x++)
+      for(size_t c = 0; c < a.channels; c++)
+        to_pixel(out[k++], in[c * a.cstride + x * a.xstride + y * a.ystride]);
+}
+
+/* Converts one frame of an R array into a new Frame. The data pointer must be
+ * obtained on the main thread. Raw arrays that are already interleaved are
+ * imported without an intermediate copy. */
+static Frame array_frame(int type, const void * data, const ArrayLayout & a){
+  size_t len = a.channels * a.width * a.height;
+  if(type == RAWSXP){
+    if(a.cstride == 1 && a.xstride == a.channels)
+      return bitmap_frame((void *) data, Magick::CharPixel, a.channels, a.width, a.height);
+    std::vector<unsigned char> buf(len);
+    interleave((const Rbyte *) data, buf.data(), a);
+    return bitmap_frame(buf.data(), Magick::CharPixel, a.channels, a.width, a.height);
+  } else if(type == INTSXP){
+    std::vector<unsigned char> buf(len);
+    interleave((const int *) data, buf.data(), a);
+    return bitmap_frame(buf.data(), Magick::CharPixel, a.channels, a.width, a.height);
+  } else {
+    std::vector<double> buf(len);
+    interleave((const double *) data, buf.data(), a);
+    return bitmap_frame(buf.data(), Magick::DoublePixel, a.channels, a.width, a.height);
+  }
+}
+
+/* Reads a list of 3D or 4D arrays, in which each 3D slice is a frame. The
+ * frames are constructed in parallel. */
 // [[Rcpp::export]]
-XPtrImage magick_image_readbin(Rcpp::RawVector x, Rcpp::CharacterVector density, Rcpp::IntegerVector depth,
-                               bool strip, Rcpp::CharacterVector defines){
+XPtrImage magick_image_readarray(Rcpp::List arrays, std::string layout){
+  std::vector<int> types;
+  std::vector<const void *> data;
+  std::vector<ArrayLayout> layouts;
+  for(int i = 0; i < arrays.size(); i++){
+    SEXP x = arrays[i];
+    ArrayLayout a = array_layout(x, layout);
+    size_t len = a.channels * a.width * a.height;
+    for(size_t j = 0; j < a.frames; j++){
+      switch(TYPEOF(x)){
+        case RAWSXP: data.push_back(RAW(x) + j * len); break;
+        case INTSXP: data.push_back(INTEGER(x) + j * len); break;
+        case REALSXP: data.push_back(REAL(x) + j * len); break;
+        default: throw std::runtime_error("Unsupported bitmap array type");
+      }
+      types.push_back(TYPEOF(x));
+      layouts.push_back(a);
+    }
+  }
+  Image frames(data.size());
+  parallel_for(frames.size(), [&](size_t i){
+    frames[i] = array_frame(types[i], data[i], layouts[i]);
+  });
   XPtrImage image = create();
+  image->swap(frames);
+  return image;
+}
+
+static void check_region(Frame & frame, const Magick::Geometry & geom){
+  if((ssize_t) geom.xOff() < 0 || (ssize_t) geom.yOff() < 0 || geom.xOff() + geom.width() > frame.columns() ||
+     geom.yOff() + geom.height() > frame.rows())
+    throw std::runtime_error("Region exceeds the size of the frame");
+}
+
+/* Writes pixels straight into the pixel cache of an existing frame, such that
+ * only the rows of the region are touched and the frame keeps its attributes.
+ * The pixels are cloned only if they are shared with another image. */
+static void import_pixels(Frame & frame, Magick::Geometry region, const std::string & map,
+                          Magick::StorageType type, const void * data){
+  frame.modifyImage();
+#if MagickLibVersion >= 0x700
+  MagickCore::ExceptionInfo * exception = MagickCore::AcquireExceptionInfo();
+  bool ok = MagickCore::ImportImagePixels(frame.image(), region.xOff(), region.yOff(), region.width(),
+                                          region.height(), map.c_str(), type, data, exception);
+  std::string reason = exception->reason ? exception->reason : "";
+  MagickCore::DestroyExceptionInfo(exception);
+#else
+  bool ok = MagickCore::ImportImagePixels(frame.image(), region.xOff(), region.yOff(), region.width(),
+                                          region.height(), map.c_str(), type, data);
+  std::string reason = frame.image()->exception.reason ? frame.image()->exception.reason : "";
+#endif
+  if(!ok)
+    throw std::runtime_error("Failed to import pixels: " + reason);
+}
+
+/* Gray or gray-alpha pixels are written to all color channels of a color frame */
+template <typename S>
+static void expand_gray(std::vector<S> & buf, size_t channels){
+  std::vector<S> out(buf.size() / channels * (channels + 2));
+  for(size_t i = 0, k = 0; i < buf.size(); i += channels){
+    out[k++] = buf[i];
+    out[k++] = buf[i];
+    out[k++] = buf[i];
+    if(channels == 2)
+      out[k++] = buf[i + 1];
+  }
+  buf.swap(out);
+}
+
+template <typename T, typename S>
+static void upload_array(Frame & frame, const T * in, const ArrayLayout & a, Magick::Geometry region,
+                         Magick::StorageType type){
+  bool gray = frame.colorSpace() == Magick::GRAYColorspace;
+  std::vector<S> buf(a.channels * a.width * a.height);
+  interleave(in, buf.data(), a);
+  std::string map;
+  if(gray){
+    map = a.channels == 1 ? "I" : "IA";
+  } else {
+    if(a.channels < 3)
+      expand_gray(buf, a.channels);
+    map = bitmap_map(a.channels < 3 ? a.channels + 2 : a.channels);
+  }
+  import_pixels(frame, region, map, type, buf.data());
+}
+
+/* Overwrites a region of an existing frame with a 3D array. Color data written
+ * to a gray frame first converts the frame to sRGB, and alpha data adds an
+ * alpha channel if needed. Other colorspaces are not supported. */
+// [[Rcpp::export]]
+XPtrImage magick_image_set_data(XPtrImage input, SEXP x, std::string layout, size_t frame,
+                                Rcpp::CharacterVector region){
+  ArrayLayout a = array_layout(x, layout);
+  if(a.frames != 1)
+    throw std::runtime_error("Pixel data must be a 3D array");
+  XPtrImage output = modify(input);
+  if(frame < 1 || frame > output->size())
+    throw std::runtime_error("Frame index out of range");
+  Frame & target = output->at(frame - 1);
+  Magick::Geometry geom = region.size() ? Geom(region.at(0)) : Magick::Geometry(a.width, a.height);
+  if(!geom.width() && !geom.height()){
+    geom.width(a.width);
+    geom.height(a.height);
+  }
+  if(geom.width() != a.width || geom.height() != a.height)
+    throw std::runtime_error("Size of region does not match the dimensions of the pixel data");
+  check_region(target, geom);
+  Magick::ColorspaceType space = target.colorSpace();
+  if(space == Magick::GRAYColorspace && a.channels > 2)
+    target.colorSpace(Magick::sRGBColorspace);
+  else if(space != Magick::GRAYColorspace && space != Magick::sRGBColorspace && space != Magick::RGBColorspace)
+    throw std::runtime_error("Pixel data can only be written to RGB or gray frames");
+  if(a.channels % 2 == 0 && !target.hasMatte())
+    Magick::myMatteImage(true)(target);
+  switch(TYPEOF(x)){
+    case RAWSXP: upload_array<Rbyte, unsigned char>(target, RAW(x), a, geom, Magick::CharPixel); break;
+    case INTSXP: upload_array<int, unsigned char>(target, INTEGER(x), a, geom, Magick::CharPixel); break;
+    case REALSXP: upload_array<double, double>(target, REAL(x), a, geom, Magick::DoublePixel); break;
+    default: throw std::runtime_error("Unsupported bitmap array type");
+  }
+  return output;
+}
+
+/* Raises a single error that lists all inputs for which an error was recorded */
+static void throw_collected_errors(const char * what, const std::vector<std::string> & labels,
+                                   const std::vector<std::string> & errors){
+  std::string msg;
+  size_t failed = 0;
+  for(size_t i = 0; i < errors.size(); i++){
+    if(errors[i].length()){
+      failed++;
+      msg += "\n - " + labels[i] + ": " + errors[i];
+    }
+  }
+  if(errors.size() == 1 && failed)
+    throw std::runtime_error(errors[0]);
+  if(failed)
+    throw std::runtime_error("Failed to " + std::string(what) + " " + std::to_string(failed) + " of " +
+                             std::to_string(errors.size()) + " images:" + msg);
+}
+
+/* Decodes a number of inputs in parallel and appends the frames to 'out' in
+ * input order. Errors are collected such that all failures can be reported at
+ * once, rather than aborting at the first one. */
+static void read_parallel(Image * out, const std::vector<std::string> & labels,
+                          std::function<void (Image &, size_t)> read){
+  size_t len = labels.size();
+  std::vector<Image> results(len);
+  std::vector<std::string> errors(len);
+  parallel_for(len, [&](size_t i){
+    try {
+      read(results[i], i);
+    } catch (std::exception & e) {
+      errors[i] = e.what();
+    }
+  });
+  throw_collected_errors("read", labels, errors);
+  for(size_t i = 0; i < len; i++)
+    out->insert(out->end(), results[i].begin(), results[i].end());
+}
+
 #if MagickLibVersion >= 0x689
+/* Options that are shared by all readers. The size is a hint for decoders that
+ * can decode at a reduced scale, such as libjpeg which then only decodes the
+ * DCT coefficients needed for 1/2, 1/4 or 1/8 of the size. The region is the
+ * extract geometry: decoders that support it, such as JPEG 2000 and raw pixel
+ * formats, only decode that part of the image; for other formats the image is
+ * cropped right after decoding. */
+static Magick::ReadOptions read_options(Rcpp::CharacterVector density, Rcpp::IntegerVector depth,
+                                        Rcpp::CharacterVector defines, Rcpp::CharacterVector size,
+                                        Rcpp::CharacterVector region){
   Magick::ReadOptions opts = Magick::ReadOptions();
 #if MagickLibVersion >= 0x690
   opts.quiet(1);
@@ -79,15 +380,206 @@ XPtrImage magick_image_readbin(Rcpp::RawVector x, Rcpp::CharacterVector density,
     opts.density(std::string(density.at(0)).c_str());
   if(depth.size())
     opts.depth(depth.at(0));
+  // The extract geometry would be applied to the reduced scale image
+  if(size.size() && !region.size())
+    MagickCore::SetImageOption(opts.imageInfo(), "jpeg:size", size.at(0));
+  if(region.size()){
+    // Without an offset the extract geometry resizes rather than crops
+    std::string extract(region.at(0));
+    if(extract.find_first_of("+-") == std::string::npos)
+      extract += "+0+0";
+    MagickCore::CloneString(&opts.imageInfo()->extract, extract.c_str());
+  }
   if(defines.size()){
     Rcpp::CharacterVector names = defines.names();
     for(int i = 0; i < defines.size(); i++)
       MagickCore::SetImageOption(opts.imageInfo(), names.at(i), defines.at(i));
   }
-  Magick::readImages(image.get(), Magick::Blob(x.begin(), x.length()), opts);
+  set_time_monitor(opts.imageInfo());
+  return opts;
+}
+#endif
+
+/* Selection of frames to read, where the scenes are the zero-based frame
+ * numbers in the file, sorted and without duplicates. */
+typedef struct {
+  std::vector<size_t> requested;
+  std::vector<size_t> scenes;
+  bool coalesce;
+} FrameSelection;
+
+static FrameSelection frame_selection(Rcpp::IntegerVector frames, bool coalesce){
+  FrameSelection sel;
+  sel.coalesce = coalesce;
+  for(int i = 0; i < frames.size(); i++){
+    if(frames[i] == NA_INTEGER || frames[i] < 1)
+      throw std::runtime_error("Frame numbers must be positive integers");
+    sel.requested.push_back(frames[i] - 1);
+  }
+  sel.scenes = sel.requested;
+  std::sort(sel.scenes.begin(), sel.scenes.end());
+  sel.scenes.erase(std::unique(sel.scenes.begin(), sel.scenes.end()), sel.scenes.end());
+  return sel;
+}
+
+/* Scene list such as "0,4-9" in the syntax of the file[0,4-9] suffix */
+static std::string scene_string(const std::vector<size_t> & scenes){
+  std::string out;
+  for(size_t i = 0; i < scenes.size(); i++){
+    size_t j = i;
+    while(j + 1 < scenes.size() && scenes[j + 1] == scenes[j] + 1)
+      j++;
+    if(out.length())
+      out += ",";
+    out += std::to_string(scenes[i]);
+    if(j > i)
+      out += "-" + std::to_string(scenes[j]);
+    i = j;
+  }
+  return out;
+}
+
+static bool is_gif(const char * magic, size_t len){
+  return len >= 4 && memcmp(magic, "GIF8", 4) == 0;
+}
+
+#if MagickLibVersion >= 0x689
+/* Coder that ImageMagick selects for a path, from a prefix such as gif:, the
+ * file extension or the magic bytes. A subimage suffix such as [2-5] is ignored
+ * and the file is opened the same way as by the coder itself. */
+static std::string read_coder(const std::string & path, Magick::ReadOptions opts){
+  MagickCore::ImageInfo * info = opts.imageInfo();
+  MagickCore::CopyMagickString(info->filename, path.c_str(), sizeof(info->filename));
+  MagickCore::ExceptionInfo *exception = MagickCore::AcquireExceptionInfo();
+  MagickCore::SetImageInfo(info, 0, exception);
+  MagickCore::DestroyExceptionInfo(exception);
+  return info->magick;
+}
+#endif
+
+static bool is_gif_frames(const Image & frames){
+  return frames.size() && frames.front().magick() == "GIF";
+}
+
+/* Reads only the selected frames: coders skip the scenes that are not in the
+ * range and stop decoding after the last one. GIF frames can depend on the
+ * previous frames, so for coalescing all frames up to the last selected one are
+ * read and coalesced, but not the ones after it. GIF images are coalesced here
+ * rather than in R, such that frames are resized after coalescing. Whether the
+ * frames are GIF is decided by the decoded frames, where `gif` only tells up
+ * front that the preceding frames should be read as well. */
+static void read_frames(Image * out, const FrameSelection & sel, Magick::ReadOptions opts, bool gif,
+                        std::function<void (Image *, Magick::ReadOptions &)> read){
+  // The extract geometry would crop each GIF frame at its own offset before
+  // coalescing, so the region is cropped from the coalesced frames instead
+  std::string region;
+  if(gif && sel.coalesce && opts.imageInfo()->extract){
+    region = opts.imageInfo()->extract;
+    MagickCore::CloneString(&opts.imageInfo()->extract, (const char *) NULL);
+  }
+  Image result;
+  if(!sel.scenes.size()){
+    read(&result, opts);
+    if(sel.coalesce && result.size() > 1 && is_gif_frames(result)){
+      if(!gif && opts.imageInfo()->extract){
+        read_frames(out, sel, opts, true, read);
+        return;
+      }
+      Image coalesced;
+      Magick::coalesceImages(&coalesced, result.begin(), result.end());
+      result.swap(coalesced);
+    }
+  } else {
+    std::vector<size_t> scenes = sel.scenes;
+    bool prefix = gif && sel.coalesce;
+    if(prefix){
+      scenes.resize(sel.scenes.back() + 1);
+      for(size_t i = 0; i < scenes.size(); i++)
+        scenes[i] = i;
+    }
+    MagickCore::ImageInfo * info = opts.imageInfo();
+    info->scene = scenes.front();
+    info->number_scenes = scenes.back() - scenes.front() + 1;
+    MagickCore::CloneString(&info->scenes, scene_string(scenes).c_str());
+    Image frames;
+    read(&frames, opts);
+    if(!prefix && sel.coalesce && is_gif_frames(frames)){
+      // Only found out after decoding: read again including the preceding frames
+      if(scenes.back() + 1 > scenes.size() || info->extract){
+        read_frames(out, sel, opts, true, read);
+        return;
+      }
+      prefix = true;
+    }
+    if(frames.size() < scenes.size())
+      throw std::runtime_error("Requested frame " + std::to_string(scenes.back() + 1) +
+                               " but the image has fewer frames");
+    if(frames.size() > scenes.size())
+      throw std::runtime_error("Decoder returned " + std::to_string(frames.size()) + " frames where " +
+                               std::to_string(scenes.size()) + " were requested");
+    // Match frames by the scene number set by the coder, or by position if it did not number them
+    std::vector<size_t> position(scenes.size());
+    std::vector<bool> found(scenes.size(), false);
+    bool numbered = true;
+    for(size_t i = 0; i < frames.size() && numbered; i++){
+      size_t scene = frames[i].scene();
+      size_t k = std::lower_bound(scenes.begin(), scenes.end(), scene) - scenes.begin();
+      numbered = k < scenes.size() && scenes[k] == scene && !found[k];
+      if(numbered){
+        found[k] = true;
+        position[k] = i;
+      }
+    }
+    for(size_t k = 0; k < scenes.size() && !numbered; k++)
+      position[k] = k;
+    if(prefix){
+      Image coalesced;
+      Magick::coalesceImages(&coalesced, frames.begin(), frames.end());
+      frames.swap(coalesced);
+    }
+    for(size_t i = 0; i < sel.requested.size(); i++){
+      size_t k = std::lower_bound(scenes.begin(), scenes.end(), sel.requested[i]) - scenes.begin();
+      result.push_back(frames.at(position[k]));
+    }
+  }
+  if(region.length())
+    for_each(result.begin(), result.end(), Magick::cropImage(Geom(region.c_str())));
+  out->insert(out->end(), result.begin(), result.end());
+}
+
+/* Resizes frames that were decoded with a size hint to the exact size, as the
+ * decoder only reduces by a power of two and not all decoders support it. */
+static void resize_frames(Image & frames, const std::string & size){
+  if(!size.length())
+    return;
+  Magick::Geometry geom = Geom(size.c_str());
+  for(size_t i = 0; i < frames.size(); i++)
+    frames[i].resize(geom);
+}
+
+// [[Rcpp::export]]
+XPtrImage magick_image_readbin(Rcpp::RawVector x, Rcpp::CharacterVector density, Rcpp::IntegerVector depth,
+                               bool strip, Rcpp::CharacterVector defines, Rcpp::CharacterVector size,
+                               Rcpp::CharacterVector region, Rcpp::IntegerVector frames, bool coalesce){
+  XPtrImage image = create();
+#if MagickLibVersion >= 0x689
+  Magick::ReadOptions opts = read_options(density, depth, defines, size, region);
+  Magick::Blob blob(x.begin(), x.length());
+  read_frames(image.get(), frame_selection(frames, coalesce), opts, is_gif((const char *) x.begin(), x.length()),
+              [&](Image * out, Magick::ReadOptions & local){
+    Magick::readImages(out, blob, local);
+  });
 #else
   Magick::readImages(image.get(), Magick::Blob(x.begin(), x.length()));
+  if(coalesce && image->size() > 1 && is_gif_frames(*image)){
+    Image coalesced;
+    Magick::coalesceImages(&coalesced, image->begin(), image->end());
+    image->swap(coalesced);
+  }
 #endif
+  check_time_limit();
+  if(size.size())
+    parallel_for_each(image->begin(), image->end(), Magick::resizeImage(Geom(size.at(0))));
   if(strip)
     for_each (image->begin(), image->end(), Magick::stripImage());
   return image;
@@ -95,45 +587,541 @@ XPtrImage magick_image_readbin(Rcpp::RawVector x, Rcpp::CharacterVector density,
 
 // [[Rcpp::export]]
 XPtrImage magick_image_readpath(Rcpp::CharacterVector paths, Rcpp::CharacterVector density, Rcpp::IntegerVector depth,
-                                bool strip, Rcpp::CharacterVector defines){
+                                bool strip, Rcpp::CharacterVector defines, Rcpp::CharacterVector size,
+                                Rcpp::CharacterVector region, Rcpp::IntegerVector frames, bool coalesce){
   XPtrImage image = create();
+  std::string geom = size.size() ? std::string(size.at(0)) : std::string();
 #if MagickLibVersion >= 0x689
-  Magick::ReadOptions opts = Magick::ReadOptions();
-#if MagickLibVersion >= 0x690
-  opts.quiet(1);
-#endif
-  if(density.size())
-    opts.density(std::string(density.at(0)).c_str());
-  if(depth.size())
-    opts.depth(depth.at(0));
-  if(defines.size()){
-    Rcpp::CharacterVector names = defines.names();
-    for(int i = 0; i < defines.size(); i++)
-      MagickCore::SetImageOption(opts.imageInfo(), names.at(i), defines.at(i));
-  }
-  for(int i = 0; i < paths.size(); i++)
-    Magick::readImages(image.get(), std::string(paths[i]), opts);
+  Magick::ReadOptions opts = read_options(density, depth, defines, size, region);
+  FrameSelection sel = frame_selection(frames, coalesce);
+  std::vector<std::string> input = Rcpp::as<std::vector<std::string> >(paths);
+  read_parallel(image.get(), input, [&](Image & out, size_t i){
+    bool gif = sel.coalesce && (sel.scenes.size() || region.size()) && read_coder(input[i], opts) == "GIF";
+    read_frames(&out, sel, opts, gif, [&](Image * frames, Magick::ReadOptions & local){
+      Magick::readImages(frames, input[i], local);
+    });
+    resize_frames(out, geom);
+  });
 #else
-  for(int i = 0; i < paths.size(); i++)
-    Magick::readImages(image.get(), std::string(paths[i]));
+  for(int i = 0; i < paths.size(); i++){
+    Image frames;
+    Magick::readImages(&frames, std::string(paths[i]));
+    if(coalesce && frames.size() > 1 && is_gif_frames(frames)){
+      Image coalesced;
+      Magick::coalesceImages(&coalesced, frames.begin(), frames.end());
+      frames.swap(coalesced);
+    }
+    image->insert(image->end(), frames.begin(), frames.end());
+  }
+  resize_frames(*image, geom);
 #endif
+  check_time_limit();
   if(strip)
     for_each (image->begin(), image->end(), Magick::stripImage());
   return image;
 }
 
+#ifdef _WIN32
+/* Paths from native_paths() are UTF-8 on Windows, which the narrow file functions
+ * would read in the ANSI code page, so these are converted to UTF-16 for the
+ * wide functions instead. */
+static std::wstring wide_path(const std::string & path){
+  std::wstring wpath;
+  for(size_t i = 0; i < path.length();){
+    unsigned char c = path[i];
+    size_t n = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+    uint32_t code = n == 1 ? c : c & (0x7F >> n);
+    for(size_t k = 1; k < n && i + k < path.length(); k++)
+      code = (code << 6) | (path[i + k] & 0x3F);
+    i += n;
+    if(code >= 0x10000){
+      wpath.push_back((wchar_t) (0xD800 + ((code - 0x10000) >> 10)));
+      wpath.push_back((wchar_t) (0xDC00 + ((code - 0x10000) & 0x3FF)));
+    } else {
+      wpath.push_back((wchar_t) code);
+    }
+  }
+  return wpath;
+}
+#endif
+
+static FILE * fopen_native(const std::string & path, const char * mode){
+#ifdef _WIN32
+  std::wstring wmode(mode, mode + strlen(mode));
+  return _wfopen(wide_path(path).c_str(), wmode.c_str());
+#else
+  return fopen(path.c_str(), mode);
+#endif
+}
+
+/* Frames of image_open() are placeholders that were pinged: they have the size
+ * and other header attributes of the frame but no pixels. Artifacts record the
+ * file and scene to decode the frame from once the pixels are needed, and the
+ * size and modification time of the file when it was opened. */
+#define SOURCE_PATH "magick:source-path"
+#define SOURCE_SCENE "magick:source-scene"
+#define SOURCE_DENSITY "magick:source-density"
+#define SOURCE_STAMP "magick:source-stamp"
+
+/* Size and modification time of a file, to detect that it was replaced */
+static std::string file_stamp(const std::string & path){
+#ifdef _WIN32
+  struct _stat64 info;
+  if(_wstat64(wide_path(path).c_str(), &info) != 0)
+    return std::string();
+#else
+  struct stat info;
+  if(stat(path.c_str(), &info) != 0)
+    return std::string();
+#endif
+  return std::to_string((double) info.st_size) + "@" + std::to_string((double) info.st_mtime);
+}
+
+static std::string source_artifact(const Frame & frame, const char * name){
+  const char * value = MagickCore::GetImageArtifact(frame.constImage(), name);
+  return value ? value : "";
+}
+
+#if MagickLibVersion >= 0x689
+/* Reads the headers of all frames in a file, without pixels */
+static MagickCore::Image * ping_list(const std::string & path, Magick::ReadOptions opts){
+  MagickCore::CopyMagickString(opts.imageInfo()->filename, path.c_str(), sizeof(opts.imageInfo()->filename));
+  MagickCore::ExceptionInfo *exception = MagickCore::AcquireExceptionInfo();
+  MagickCore::Image *images = MagickCore::PingImage(opts.imageInfo(), exception);
+  if(images == NULL){
+    std::string msg = exception->severity >= MagickCore::ErrorException && exception->reason ?
+      std::string(exception->reason) : std::string("Failed to read image headers");
+    MagickCore::DestroyExceptionInfo(exception);
+    throw std::runtime_error(msg);
+  }
+  MagickCore::DestroyExceptionInfo(exception);
+  return images;
+}
+
+static void ping_frames(Image & out, const std::string & path, Magick::ReadOptions opts,
+                        const std::string & density){
+  std::string stamp = file_stamp(path);
+  MagickCore::Image *images = ping_list(path, opts);
+  size_t scene = 0;
+  MagickCore::Image * next;
+  while((next = MagickCore::RemoveFirstImageFromList(&images)) != NULL){
+    Frame frame(next);
+    frame.artifact(SOURCE_PATH, path);
+    frame.artifact(SOURCE_SCENE, std::to_string(scene++));
+    frame.artifact(SOURCE_STAMP, stamp);
+    if(density.length())
+      frame.artifact(SOURCE_DENSITY, density);
+    out.push_back(frame);
+  }
+}
+#endif
+
+// [[Rcpp::export]]
+XPtrImage magick_image_open(Rcpp::CharacterVector paths, Rcpp::CharacterVector density){
+  XPtrImage image = create();
+  std::vector<std::string> input = Rcpp::as<std::vector<std::string> >(paths);
+#if MagickLibVersion >= 0x689
+  Magick::ReadOptions opts = read_options(density, Rcpp::IntegerVector(), Rcpp::CharacterVector(),
+                                          Rcpp::CharacterVector(), Rcpp::CharacterVector());
+  std::string dens = density.size() ? std::string(density.at(0)) : std::string();
+  read_parallel(image.get(), input, [&](Image & out, size_t i){
+    ping_frames(out, input[i], opts, dens);
+  });
+#else
+  // No scene selection: decode right away
+  for(size_t i = 0; i < input.size(); i++)
+    Magick::readImages(image.get(), input[i]);
+#endif
+  image.attr("class") = Rcpp::CharacterVector::create("magick-deferred", "magick-image");
+  return image;
+}
+
+/* Decoded frames of opened files, shared by all images that refer to the same
+ * frame. The least recently used frames are dropped once the total size exceeds
+ * the budget. A dropped frame stays alive in the images that use it, but is
+ * decoded again when another placeholder for it is evaluated. */
+typedef struct {
+  std::string key;
+  Frame frame;
+  double bytes;
+} CachedFrame;
+
+static std::list<CachedFrame> frame_cache;
+static std::unordered_map<std::string, std::list<CachedFrame>::iterator> frame_cache_index;
+static double frame_cache_bytes = 0;
+
+static void frame_cache_trim(double budget){
+  while(frame_cache.size() && frame_cache_bytes > budget){
+    frame_cache_bytes -= frame_cache.back().bytes;
+    frame_cache_index.erase(frame_cache.back().key);
+    frame_cache.pop_back();
+  }
+}
+
+static bool frame_cache_get(const std::string & key, Frame & out){
+  auto it = frame_cache_index.find(key);
+  if(it == frame_cache_index.end())
+    return false;
+  frame_cache.splice(frame_cache.begin(), frame_cache, it->second);
+  out = it->second->frame;
+  return true;
+}
+
+static void frame_cache_put(const std::string & key, const Frame & frame, double budget){
+  double bytes = (double) frame.columns() * frame.rows() * 4 * sizeof(MagickCore::Quantum);
+  if(bytes > budget || frame_cache_index.count(key))
+    return;
+  frame_cache.push_front({key, frame, bytes});
+  frame_cache_index[key] = frame_cache.begin();
+  frame_cache_bytes += bytes;
+  frame_cache_trim(budget);
+}
+
+/* Returns a copy of an image in which the placeholders are replaced by the
+ * decoded frames. The image itself keeps its placeholders, such that only the
+ * cache holds on to decoded pixels. Each distinct frame is decoded once, in
+ * parallel, unless it is in the cache. */
+// [[Rcpp::export]]
+XPtrImage magick_image_materialize(XPtrImage input, double budget){
+  XPtrImage image = copy(input);
+  frame_cache_trim(budget);
+  std::vector<std::string> keys;
+  std::vector<std::vector<size_t> > targets;
+  std::unordered_map<std::string, size_t> pending;
+  for(size_t i = 0; i < image->size(); i++){
+    Frame & frame = image->at(i);
+    std::string path = source_artifact(frame, SOURCE_PATH);
+    if(!path.length())
+      continue;
+    std::string key = path + "[" + source_artifact(frame, SOURCE_SCENE) + "]" + source_artifact(frame, SOURCE_DENSITY) +
+      "@" + source_artifact(frame, SOURCE_STAMP);
+    if(frame_cache_get(key, frame))
+      continue;
+    auto it = pending.find(key);
+    if(it == pending.end()){
+      pending[key] = keys.size();
+      keys.push_back(key);
+      targets.push_back(std::vector<size_t>(1, i));
+    } else {
+      targets[it->second].push_back(i);
+    }
+  }
+  if(!keys.size())
+    return image;
+#if MagickLibVersion >= 0x689
+  Magick::ReadOptions opts = read_options(Rcpp::CharacterVector(), Rcpp::IntegerVector(), Rcpp::CharacterVector(),
+                                          Rcpp::CharacterVector(), Rcpp::CharacterVector());
+  std::vector<Frame> sources(keys.size());
+  std::vector<std::string> labels(keys.size());
+  for(size_t k = 0; k < keys.size(); k++){
+    sources[k] = image->at(targets[k].front());
+    labels[k] = source_artifact(sources[k], SOURCE_PATH);
+  }
+  Image decoded;
+  read_parallel(&decoded, labels, [&](Image & out, size_t k){
+    if(file_stamp(labels[k]) != source_artifact(sources[k], SOURCE_STAMP))
+      throw std::runtime_error("File has changed since it was opened");
+    FrameSelection sel;
+    sel.requested.push_back(std::stoul(source_artifact(sources[k], SOURCE_SCENE)));
+    sel.scenes = sel.requested;
+    sel.coalesce = false;
+    Magick::ReadOptions local(opts);
+    std::string density = source_artifact(sources[k], SOURCE_DENSITY);
+    if(density.length())
+      local.density(density.c_str());
+    read_frames(&out, sel, local, false, [&](Image * frames, Magick::ReadOptions & scene){
+      Magick::readImages(frames, labels[k], scene);
+    });
+  });
+  for(size_t k = 0; k < keys.size(); k++){
+    for(size_t j = 0; j < targets[k].size(); j++)
+      image->at(targets[k][j]) = decoded.at(k);
+    frame_cache_put(keys[k], decoded.at(k), budget);
+  }
+#endif
+  return image;
+}
+
+/* Reads the frames of a file in batches, such that only the frames of the
+ * current batch are in memory. The GIF decoder keeps all frames up to the last
+ * requested scene, so GIF files are instead split into frames by scanning the
+ * blocks of the file, and each frame is decoded from a small GIF of its own.
+ * Other formats are read by scene range, which decoders such as TIFF and PDF
+ * can seek to. */
+class FrameStream {
+public:
+  std::string path;
+#if MagickLibVersion >= 0x689
+  Magick::ReadOptions opts;
+#endif
+  bool gif;
+  bool coalesce;
+  bool done;
+  size_t scene;
+  size_t total;
+  FILE * file;
+  std::string head;
+  Frame canvas;
+  bool has_canvas;
+  FrameStream(const std::string & path, bool coalesce) : path(path), gif(false), coalesce(coalesce),
+    done(false), scene(0), total(0), file(NULL), has_canvas(false) {}
+  ~FrameStream(){
+    if(file)
+      fclose(file);
+  }
+};
+
+void finalize_stream(FrameStream *stream){
+  delete stream;
+}
+
+#if MagickLibVersion >= 0x689
+static std::string read_bytes(FILE * file, size_t n){
+  std::string buf(n, '\0');
+  if(n && fread(&buf[0], 1, n, file) != n)
+    throw std::runtime_error("Unexpected end of GIF file");
+  return buf;
+}
+
+/* Appends data sub-blocks up to and including the zero-length terminator */
+static void read_sub_blocks(FILE * file, std::string & out){
+  for(;;){
+    std::string size = read_bytes(file, 1);
+    out += size;
+    if(!size[0])
+      return;
+    out += read_bytes(file, (unsigned char) size[0]);
+  }
+}
+
+static size_t color_table_size(char packed){
+  return packed & 0x80 ? 3 * (2 << (packed & 0x07)) : 0;
+}
+
+/* The header, screen descriptor and global color table are shared by all frames */
+static void open_gif(FrameStream & s){
+  s.file = fopen_native(s.path, "rb");
+  if(s.file == NULL)
+    throw std::runtime_error("Failed to open file " + s.path);
+  s.head = read_bytes(s.file, 13);
+  s.head += read_bytes(s.file, color_table_size(s.head[10]));
+}
+
+/* Copies the blocks of the next frame into a standalone GIF: the shared header,
+ * the graphic control extension with the delay and dispose method, the image
+ * descriptor with its offset, and the compressed pixels. */
+static bool next_gif_frame(FrameStream & s, std::string & out, bool first){
+  std::string control;
+  for(;;){
+    int c = fgetc(s.file);
+    if(c == EOF || c == 0x3B)
+      return false;
+    if(c == 0x21){
+      std::string ext = std::string(1, (char) c) + read_bytes(s.file, 1);
+      read_sub_blocks(s.file, ext);
+      if((unsigned char) ext[1] == 0xF9)
+        control = ext;
+      else if((unsigned char) ext[1] == 0xFF && first)
+        s.head += ext; // Loop count
+    } else if(c == 0x2C){
+      std::string desc = std::string(1, (char) c) + read_bytes(s.file, 9);
+      desc += read_bytes(s.file, color_table_size(desc[9]));
+      desc += read_bytes(s.file, 1);
+      read_sub_blocks(s.file, desc);
+      out = s.head + control + desc + ";";
+      return true;
+    } else {
+      throw std::runtime_error("Invalid block in GIF file " + s.path);
+    }
+  }
+}
+
+/* Coalesces a batch onto the canvas that was left by the previous batch, and
+ * keeps the canvas after disposal of the last frame for the next batch. */
+static void coalesce_batch(FrameStream & s, Image & frames){
+  Image seq;
+  if(s.has_canvas)
+    seq.push_back(s.canvas);
+  seq.insert(seq.end(), frames.begin(), frames.end());
+  Image coalesced;
+  Magick::coalesceImages(&coalesced, seq.begin(), seq.end());
+  Magick::linkImages(seq.begin(), seq.end());
+  MagickCore::ExceptionInfo *exception = MagickCore::AcquireExceptionInfo();
+  MagickCore::Image * disposed = MagickCore::DisposeImages(seq.front().image(), exception);
+  Magick::unlinkImages(seq.begin(), seq.end());
+  MagickCore::DestroyExceptionInfo(exception);
+  if(disposed == NULL)
+    throw std::runtime_error("Failed to coalesce frames");
+  Frame canvas(MagickCore::RemoveLastImageFromList(&disposed));
+  MagickCore::DestroyImageList(disposed);
+  Magick::gifDisposeMethodImage(Magick::NoneDispose)(canvas);
+  canvas.page(Magick::Geometry(canvas.columns(), canvas.rows(), 0, 0));
+  s.canvas = canvas;
+  s.has_canvas = true;
+  frames.assign(coalesced.end() - frames.size(), coalesced.end());
+}
+
+/* The stream only advances once the whole batch was decoded, such that after
+ * an error the next call starts at the same frame again. */
+static void next_gif_batch(FrameStream & s, Image & frames, size_t n){
+  fpos_t start;
+  if(fgetpos(s.file, &start) != 0)
+    throw std::runtime_error("Failed to read GIF file " + s.path);
+  std::string head = s.head;
+  try {
+    std::vector<std::string> blobs;
+    std::string blob;
+    bool end = false;
+    while(blobs.size() < n && !end){
+      end = !next_gif_frame(s, blob, s.scene + blobs.size() == 0);
+      if(!end)
+        blobs.push_back(blob);
+    }
+    Image batch(blobs.size());
+    parallel_for(blobs.size(), [&](size_t i){
+      Image out;
+      Magick::ReadOptions local(s.opts);
+      Magick::readImages(&out, Magick::Blob(blobs[i].data(), blobs[i].size()), local);
+      batch[i] = out.at(0);
+    });
+    if(s.coalesce && batch.size())
+      coalesce_batch(s, batch);
+    frames.swap(batch);
+    s.scene += frames.size();
+    if(end){
+      s.done = true;
+      fclose(s.file);
+      s.file = NULL;
+    }
+  } catch (...) {
+    fsetpos(s.file, &start);
+    s.head = head;
+    throw;
+  }
+}
+
+static void next_scene_batch(FrameStream & s, Image & frames, size_t n){
+  FrameSelection sel;
+  sel.coalesce = false;
+  for(size_t i = s.scene; i < s.total && sel.requested.size() < n; i++)
+    sel.requested.push_back(i);
+  sel.scenes = sel.requested;
+  if(sel.requested.size()){
+    read_frames(&frames, sel, s.opts, false, [&](Image * out, Magick::ReadOptions & local){
+      Magick::readImages(out, s.path, local);
+    });
+    check_time_limit();
+  }
+  s.scene += sel.requested.size();
+  s.done = s.scene >= s.total;
+}
+#endif
+
+// [[Rcpp::export]]
+XPtrStream magick_stream_open(std::string path, Rcpp::CharacterVector density, bool coalesce){
+  FrameStream * s = new FrameStream(path, coalesce);
+  XPtrStream stream(s);
+  stream.attr("class") = Rcpp::CharacterVector::create("magick-stream");
+#if MagickLibVersion >= 0x689
+  s->opts = read_options(density, Rcpp::IntegerVector(), Rcpp::CharacterVector(),
+                         Rcpp::CharacterVector(), Rcpp::CharacterVector());
+  s->gif = read_coder(path, s->opts) == "GIF";
+  if(s->gif){
+    open_gif(*s);
+  } else {
+    MagickCore::Image * images = ping_list(path, s->opts);
+    s->total = MagickCore::GetImageListLength(images);
+    MagickCore::DestroyImageList(images);
+  }
+#else
+  throw std::runtime_error("Streaming frames requires ImageMagick 6.8.9 or newer");
+#endif
+  return stream;
+}
+
+// [[Rcpp::export]]
+XPtrImage magick_stream_next(XPtrStream stream, size_t n){
+  if(stream.get() == NULL)
+    throw std::runtime_error("Stream pointer is dead. You cannot save streams between R sessions.");
+  FrameStream & s = *stream;
+  XPtrImage image = create();
+#if MagickLibVersion >= 0x689
+  if(!s.done){
+    if(s.gif)
+      next_gif_batch(s, *image, n);
+    else
+      next_scene_batch(s, *image, n);
+  }
+#endif
+  return image;
+}
+
+// [[Rcpp::export]]
+Rcpp::List magick_stream_info(XPtrStream stream){
+  if(stream.get() == NULL)
+    throw std::runtime_error("Stream pointer is dead. You cannot save streams between R sessions.");
+  return Rcpp::List::create(
+    Rcpp::_["path"] = stream->path,
+    Rcpp::_["read"] = (double) stream->scene,
+    Rcpp::_["done"] = stream->done
+  );
+}
+
 // [[Rcpp::export]]
 XPtrImage magick_image_read_list(Rcpp::List list){
   XPtrImage image = create();
+  std::vector<Magick::Blob> input;
+  std::vector<std::string> labels;
   for(int i = 0; i < list.size(); i++) {
     if(TYPEOF(list[i]) != RAWSXP)
       throw std::runtime_error("magick_image_read_list can only read raw vectors");
     Rcpp::RawVector x = list[i];
-    Magick::readImages(image.get(), Magick::Blob(x.begin(), x.length()));
+    input.push_back(Magick::Blob(x.begin(), x.length()));
+    labels.push_back("element " + std::to_string(i + 1));
   }
+  read_parallel(image.get(), labels, [&](Image & frames, size_t i){
+    Magick::readImages(&frames, input[i]);
+  });
   return image;
 }
 
+/* Output settings of image_write(). These are copied from the R arguments on
+ * the main thread, such that they can be applied from any thread. */
+typedef struct {
+  std::vector<std::string> format, density, comment, compression;
+  std::vector<int> quality, depth;
+} WriteOptions;
+
+static WriteOptions write_options(Rcpp::CharacterVector format, Rcpp::IntegerVector quality,
+                                  Rcpp::IntegerVector depth, Rcpp::CharacterVector density,
+                                  Rcpp::CharacterVector comment, Rcpp::CharacterVector compression){
+  WriteOptions opts;
+  opts.format = Rcpp::as<std::vector<std::string> >(format);
+  opts.quality = Rcpp::as<std::vector<int> >(quality);
+  opts.depth = Rcpp::as<std::vector<int> >(depth);
+  opts.density = Rcpp::as<std::vector<std::string> >(density);
+  opts.comment = Rcpp::as<std::vector<std::string> >(comment);
+  opts.compression = Rcpp::as<std::vector<std::string> >(compression);
+  return opts;
+}
+
+static void apply_write_options(Frame & frame, const WriteOptions & opts){
+  if(opts.format.size())
+    frame.magick(opts.format[0]);
+  if(opts.quality.size())
+    frame.quality(opts.quality[0]);
+  if(opts.depth.size())
+    frame.depth(opts.depth[0]);
+  if(opts.density.size()){
+    frame.resolutionUnits(Magick::PixelsPerInchResolution);
+    frame.density(Point(opts.density[0].c_str()));
+  }
+  if(opts.comment.size())
+    frame.comment(opts.comment[0]);
+  if(opts.compression.size())
+    frame.compressType(Compression(opts.compression[0].c_str()));
+}
+
 // [[Rcpp::export]]
 Rcpp::RawVector magick_image_write( XPtrImage input, Rcpp::CharacterVector format, Rcpp::IntegerVector quality,
                                     Rcpp::IntegerVector depth, Rcpp::CharacterVector density, Rcpp::CharacterVector comment,
@@ -145,20 +1133,9 @@ Rcpp::RawVector magick_image_write( XPtrImage input, Rcpp::CharacterVector forma
   //suppress write warnings see #74 and #116
   image->front().quiet(true);
 #endif
-  if(format.size())
-    for_each ( image->begin(), image->end(), Magick::magickImage(std::string(format[0])));
-  if(quality.size())
-    for_each ( image->begin(), image->end(), Magick::qualityImage(quality[0]));
-  if(depth.size())
-    for_each ( image->begin(), image->end(), Magick::depthImage(depth[0]));
-  if(density.size()){
-    for_each ( image->begin(), image->end(), Magick::resolutionUnitsImage(Magick::PixelsPerInchResolution));
-    for_each ( image->begin(), image->end(), Magick::densityImage(Point(density[0])));
-  }
-  if(comment.size())
-    for_each ( image->begin(), image->end(), Magick::commentImage(std::string(comment.at(0))));
-  if(compression.size())
-    for_each ( image->begin(), image->end(), Magick::compressTypeImage(Compression(std::string(compression.at(0)).c_str())));
+  WriteOptions opts = write_options(format, quality, depth, density, comment, compression);
+  for(Iter it = image->begin(); it != image->end(); ++it)
+    apply_write_options(*it, opts);
   Magick::Blob output;
   writeImages( image->begin(), image->end(),  &output );
   Rcpp::RawVector res(output.length());
@@ -166,25 +1143,175 @@ Rcpp::RawVector magick_image_write( XPtrImage input, Rcpp::CharacterVector forma
   return res;
 }
 
+/* Formats that cannot hold multiple frames are written one file per frame,
+ * with a scene number appended to the file name. */
+static bool format_adjoin(const std::string & format){
+  MagickCore::ExceptionInfo *exception = MagickCore::AcquireExceptionInfo();
+  const MagickCore::MagickInfo *info = MagickCore::GetMagickInfo(format.c_str(), exception);
+  MagickCore::DestroyExceptionInfo(exception);
+  return info && MagickCore::GetMagickAdjoin(info);
+}
+
+/* Encodes straight to a file, which avoids holding the encoded image in memory
+ * twice (Blob and raw vector). The format of the image is used as a prefix,
+ * such that the output is the same as magick_image_write() for any file name.
+ * As with a Blob, only the first frame is written for single frame formats. */
 // [[Rcpp::export]]
-Rcpp::RawVector magick_image_write_frame(XPtrImage input, const char * format, size_t i = 1){
+void magick_image_write_file( XPtrImage input, std::string path, Rcpp::CharacterVector format, Rcpp::IntegerVector quality,
+                              Rcpp::IntegerVector depth, Rcpp::CharacterVector density, Rcpp::CharacterVector comment,
+                              Rcpp::CharacterVector compression){
+  if(!input->size())
+    throw std::runtime_error("Cannot write image with 0 frames to a file");
+  XPtrImage image = copy(input);
+#if MagickLibVersion >= 0x691
+  image->front().quiet(true);
+#endif
+  WriteOptions opts = write_options(format, quality, depth, density, comment, compression);
+  for(Iter it = image->begin(); it != image->end(); ++it)
+    apply_write_options(*it, opts);
+  std::string magick = image->front().magick();
+  Iter last = format_adjoin(magick) ? image->end() : image->begin() + 1;
+  writeImages(image->begin(), last, magick + ":" + path);
+}
+
+/* Format given by the extension of a file name, which is what ImageMagick
+ * would use, but without interpreting other parts of the path. */
+static std::string path_format(const std::string & path){
+  size_t dot = path.find_last_of('.');
+  size_t sep = path.find_last_of("/\\");
+  if(dot == std::string::npos || dot + 1 == path.length() || (sep != std::string::npos && dot < sep))
+    return std::string();
+  return path.substr(dot + 1);
+}
+
+/* Writes each frame to its own file, encoding the frames in parallel. If a
+ * format is given it overrides the file extension. Frames are encoded to a
+ * Blob and written as is, such that characters such as '%' or '[' in the path
+ * are not interpreted by ImageMagick. */
+// [[Rcpp::export]]
+Rcpp::CharacterVector magick_image_write_files( XPtrImage input, Rcpp::CharacterVector paths, Rcpp::CharacterVector format,
+                                                Rcpp::IntegerVector quality, Rcpp::IntegerVector depth, Rcpp::CharacterVector density,
+                                                Rcpp::CharacterVector comment, Rcpp::CharacterVector compression){
+  if((size_t) paths.size() != input->size())
+    throw std::runtime_error("Number of paths must be equal to the number of frames");
+  WriteOptions opts = write_options(format, quality, depth, density, comment, compression);
+  std::vector<std::string> targets = Rcpp::as<std::vector<std::string> >(paths);
+  std::vector<std::string> errors(targets.size());
+  Image frames(*input);
+  parallel_for(frames.size(), [&](size_t i){
+    try {
+      Frame & frame = frames[i];
+#if MagickLibVersion >= 0x691
+      frame.quiet(true);
+#endif
+      apply_write_options(frame, opts);
+      std::string ext = path_format(targets[i]);
+      if(!opts.format.size() && ext.length())
+        frame.magick(ext);
+      Magick::Blob blob;
+      frame.write(&blob);
+      FILE * file = fopen_native(targets[i], "wb");
+      if(file == NULL)
+        throw std::runtime_error("Failed to open file for writing");
+      size_t len = fwrite(blob.data(), 1, blob.length(), file);
+      // Closing flushes the buffer, which can fail as well
+      if(fclose(file) != 0 || len != blob.length())
+        throw std::runtime_error("Failed to write file");
+    } catch (std::exception & e) {
+      errors[i] = e.what();
+    }
+  });
+  throw_collected_errors("write", targets, errors);
+  return paths;
+}
+
+/* Returns the ExportImagePixels() map for a raw format, or an empty string if
+ * the format must be written by the raw coder. The pixel cache is exported as
+ * is, so the image must already be in the colorspace of the format. */
+static std::string export_map(Frame & frame, std::string format){
+  std::transform(format.begin(), format.end(), format.begin(), ::toupper);
+  Magick::ColorspaceType space = frame.colorSpace();
+  bool rgb = space == Magick::sRGBColorspace || space == Magick::RGBColorspace || space == Magick::GRAYColorspace;
+  if(format == "GRAY" && rgb)
+    return "I";
+  if((format == "RGB" || format == "RGBA" || format == "BGR" || format == "BGRA") && rgb)
+    return format;
+  if((format == "CMYK" || format == "CMYKA") && space == Magick::CMYKColorspace)
+    return format;
+  return std::string();
+}
+
+/* Fills a newly allocated R vector straight from the pixel cache. The layout is
+ * either interleaved (channels x width x height) or planar (width x height x
+ * channels), where the latter exports each channel separately. */
+static void export_pixels(Frame & frame, Magick::Geometry region, const std::string & map,
+                          bool planar, Magick::StorageType type, void * out, size_t elsize){
+  size_t width = region.width();
+  size_t height = region.height();
+  if(!planar){
+    frame.write(region.xOff(), region.yOff(), width, height, map, type, out);
+    return;
+  }
+  for(size_t i = 0; i < map.length(); i++)
+    frame.write(region.xOff(), region.yOff(), width, height, map.substr(i, 1), type,
+                (char *) out + i * width * height * elsize);
+}
+
+/* Region of a frame to export: the full frame by default, or a geometry such
+ * as "64x64+100+200" which must lie within the frame. */
+static Magick::Geometry frame_region(Frame & frame, const std::string & region){
+  if(!region.length())
+    return Magick::Geometry(frame.columns(), frame.rows());
+  Magick::Geometry geom = Geom(region.c_str());
+  if(!geom.width() || !geom.height())
+    throw std::runtime_error("Region must have a width and height, for example 64x64+100+200");
+  check_region(frame, geom);
+  return geom;
+}
+
+// [[Rcpp::export]]
+Rcpp::RawVector magick_image_write_frame(XPtrImage input, const char * format, size_t i = 1, bool planar = false,
+                                         std::string region = ""){
   if(input->size() < 1)
     throw std::runtime_error("Image must have at least 1 frame to write a bitmap");
   Frame frame = input->at(i-1); //zero indexing!
-  Magick::Geometry size(frame.size());
-  size_t width = size.width();
-  size_t height = size.height();
-  Magick::Blob output;
-  frame.write(&output, format, 8L);
-  if(output.length() == 0)
-    throw std::runtime_error("Unsupported raw format: " + std::string(format));
-  if(output.length() % (width * height))
-    throw std::runtime_error("Dimensions do not add up, '" + std::string(format) + "' may not be a raw format");
-  size_t slices = output.length() / (width * height);
-  Rcpp::RawVector res(output.length());
-  memcpy(res.begin(), output.data(), output.length());
-  res.attr("class") = Rcpp::CharacterVector::create("bitmap", format);
-  res.attr("dim") = Rcpp::NumericVector::create(slices, width, height);
+  Magick::Geometry geom = frame_region(frame, region);
+  size_t width = geom.width();
+  size_t height = geom.height();
+  std::string map = export_map(frame, format);
+  size_t slices = map.length();
+  Rcpp::RawVector res;
+  if(slices){
+    res = Rcpp::RawVector(slices * width * height);
+    export_pixels(frame, geom, map, planar, Magick::CharPixel, res.begin(), 1);
+  } else {
+    if(region.length()){
+      frame.crop(geom);
+      frame.myRepage();
+    }
+    Magick::Blob output;
+    frame.write(&output, format, 8L);
+    if(output.length() == 0)
+      throw std::runtime_error("Unsupported raw format: " + std::string(format));
+    if(output.length() % (width * height))
+      throw std::runtime_error("Dimensions do not add up, '" + std::string(format) + "' may not be a raw format");
+    slices = output.length() / (width * height);
+    res = Rcpp::RawVector(output.length());
+    const unsigned char * data = (const unsigned char *) output.data();
+    if(planar){
+      for(size_t j = 0; j < width * height; j++)
+        for(size_t k = 0; k < slices; k++)
+          res[k * width * height + j] = data[j * slices + k];
+    } else {
+      memcpy(res.begin(), data, output.length());
+    }
+  }
+  if(planar){
+    res.attr("dim") = Rcpp::NumericVector::create(width, height, slices);
+  } else {
+    res.attr("class") = Rcpp::CharacterVector::create("bitmap", format);
+    res.attr("dim") = Rcpp::NumericVector::create(slices, width, height);
+  }
   return res;
 }
 
@@ -196,15 +1323,149 @@ Rcpp::IntegerVector magick_image_write_integer(XPtrImage input){
   Magick::Geometry size(frame.size());
   size_t width = size.width();
   size_t height = size.height();
-  Magick::Blob output;
-  frame.write(&output, "RGBA", 8L);
-  Rcpp::IntegerVector res(output.length() / 4);
-  memcpy(res.begin(), output.data(), output.length());
+  Rcpp::IntegerVector res(width * height);
+  if(export_map(frame, "rgba").length()){
+    export_pixels(frame, Magick::Geometry(width, height), "RGBA", false, Magick::CharPixel, res.begin(), 1);
+  } else {
+    Magick::Blob output;
+    frame.write(&output, "RGBA", 8L);
+    memcpy(res.begin(), output.data(), output.length());
+  }
   res.attr("class") = Rcpp::CharacterVector::create("nativeRaster");
   res.attr("dim") = Rcpp::NumericVector::create(height, width);
   return res;
 }
 
+/* Position of each dimension of a tensor within a column-major R array, where
+ * the layout is a permutation of "NCHW" (frame, channel, row, column) that
+ * gives the order of the indices, as in x[n, c, h, w] for "NCHW". */
+typedef struct {
+  size_t frames, channels, height, width;
+  size_t nstride, cstride, ystride, xstride;
+} TensorLayout;
+
+static TensorLayout tensor_layout(std::string layout, size_t frames, size_t channels, size_t height, size_t width){
+  std::transform(layout.begin(), layout.end(), layout.begin(), ::toupper);
+  TensorLayout out = {frames, channels, height, width, 0, 0, 0, 0};
+  std::string sorted(layout);
+  std::sort(sorted.begin(), sorted.end());
+  if(sorted != "CHNW")
+    throw std::runtime_error("Tensor layout must be a permutation of NCHW, for example NCHW or NHWC");
+  size_t stride = 1;
+  for(size_t i = 0; i < 4; i++){
+    switch(layout.at(i)){
+      case 'N': out.nstride = stride; stride *= frames; break;
+      case 'C': out.cstride = stride; stride *= channels; break;
+      case 'H': out.ystride = stride; stride *= height; break;
+      case 'W': out.xstride = stride; stride *= width; break;
+    }
+  }
+  return out;
+}
+
+/* Copies an interleaved row-major frame into the tensor, normalizing each
+ * channel as (value - mean) / sd when converting to double. */
+template <typename T>
+static void scatter_frame(const T * in, T * out, const TensorLayout & t, const double * mean, const double * sd){
+  size_t k = 0;
+  for(size_t y = 0; y < t.height; y++){
+    for(size_t x = 0; x < t.width; x++){
+      T * px = out + y * t.ystride + x * t.xstride;
+      for(size_t c = 0; c < t.channels; c++, k++)
+        px[c * t.cstride] = mean ? (in[k] - mean[c]) / sd[c] : in[k];
+    }
+  }
+}
+
+/* Resizes, converts and normalizes all frames into a single R array in a
+ * single pass per frame. The frames are processed in parallel and each one is
+ * written directly into its slice of the output. */
+// [[Rcpp::export]]
+SEXP magick_image_tensor(XPtrImage input, std::string size, std::string layout, std::string channels,
+                         std::string dtype, Rcpp::NumericVector mean, Rcpp::NumericVector sd){
+  if(input->size() < 1)
+    throw std::runtime_error("Image must have at least 1 frame to export a tensor");
+  std::transform(channels.begin(), channels.end(), channels.begin(), ::toupper);
+  std::string map = channels == "GRAY" ? "I" : channels;
+  if(map != "I" && map != "RGB" && map != "RGBA")
+    throw std::runtime_error("Tensor channels must be one of gray, rgb or rgba");
+  Magick::Geometry geom = size.length() ? Geom(size.c_str()) : input->front().size();
+  if(!geom.width() || !geom.height())
+    throw std::runtime_error("Tensor size must have both a width and height, for example 224x224");
+  geom.aspect(true);
+  bool real = dtype == "double";
+  if(!real && dtype != "raw")
+    throw std::runtime_error("Tensor dtype must be double or raw");
+  size_t nc = map.length();
+  bool normalize = mean.size() || sd.size();
+  if(normalize && (!real || (size_t) mean.size() != nc || (size_t) sd.size() != nc))
+    throw std::runtime_error("Normalization requires dtype double and a mean and sd for each channel");
+  std::vector<double> m(mean.begin(), mean.end()), s(sd.begin(), sd.end());
+  TensorLayout t = tensor_layout(layout, input->size(), nc, geom.height(), geom.width());
+  Rcpp::IntegerVector dims(4);
+  for(size_t i = 0; i < 4; i++){
+    switch(::toupper(layout.at(i))){
+      case 'N': dims[i] = t.frames; break;
+      case 'C': dims[i] = t.channels; break;
+      case 'H': dims[i] = t.height; break;
+      case 'W': dims[i] = t.width; break;
+    }
+  }
+  size_t len = t.frames * t.channels * t.height * t.width;
+  SEXP out = PROTECT(Rf_allocVector(real ? REALSXP : RAWSXP, len));
+  void * data = real ? (void *) REAL(out) : (void *) RAW(out);
+  Image & frames = *input;
+  std::vector<std::string> labels(frames.size()), errors(frames.size());
+  // Unless frames are the outer dimension, the values of consecutive frames are
+  // close together in the output, as in the default NCHW. Frames are then grouped
+  // into tasks that start at a cache line, such that no two workers write to the
+  // same cache line.
+  size_t unit = t.nstride * (real ? sizeof(double) : 1);
+  std::vector<size_t> starts;
+  for(size_t i = 0; i < frames.size(); i++){
+    if(!i || unit >= 1024 || ((uintptr_t) data + i * unit) % 64 == 0)
+      starts.push_back(i);
+  }
+  starts.push_back(frames.size());
+  try {
+    parallel_for(starts.size() - 1, [&](size_t task){
+      for(size_t i = starts[task]; i < starts[task + 1]; i++){
+        labels[i] = "frame " + std::to_string(i + 1);
+        try {
+          Frame frame = frames[i];
+          if(frame.columns() != t.width || frame.rows() != t.height)
+            frame.resize(geom);
+          Magick::ColorspaceType space = frame.colorSpace();
+          if(space != Magick::sRGBColorspace && space != Magick::RGBColorspace && space != Magick::GRAYColorspace)
+            frame.colorSpace(Magick::sRGBColorspace);
+          if(frame.columns() != t.width || frame.rows() != t.height)
+            throw std::runtime_error("Frame does not have the size of the tensor");
+          Magick::Geometry region(t.width, t.height);
+          size_t pixels = t.width * t.height * nc;
+          if(real){
+            std::vector<double> buf(pixels);
+            export_pixels(frame, region, map, false, Magick::DoublePixel, buf.data(), sizeof(double));
+            scatter_frame(buf.data(), (double *) data + i * t.nstride, t, normalize ? m.data() : NULL, s.data());
+          } else {
+            std::vector<unsigned char> buf(pixels);
+            export_pixels(frame, region, map, false, Magick::CharPixel, buf.data(), 1);
+            scatter_frame(buf.data(), (unsigned char *) data + i * t.nstride, t, NULL, NULL);
+          }
+        } catch (std::exception & e) {
+          errors[i] = e.what();
+        }
+      }
+    });
+    throw_collected_errors("export", labels, errors);
+  } catch (...) {
+    UNPROTECT(1);
+    throw;
+  }
+  Rf_setAttrib(out, R_DimSymbol, dims);
+  UNPROTECT(1);
+  return out;
+}
+
 // [[Rcpp::export]]
 XPtrImage magick_image_display( XPtrImage image, bool animate){
 #ifndef MAGICKCORE_X11_DELEGATE
@@ -0,0 +1,131 @@
+/* Lazy evaluation of image operations, see image_lazy() in R.
+ * Pending operations are stored as a list of list(name, args...) in the "ops"
+ * attribute of the image. Upon evaluation adjacent operations are fused when
+ * this gives an identical result, and the remaining steps are applied to each
+ * frame in a single pass, such that no intermediate images are retained. Frames
+ * are processed in parallel, see parallel.cpp.
+ */
+
+#include "magick_types.h"
+#include <cmath>
+
+typedef struct {
+  std::string name;
+  std::vector<double> num;
+  std::vector<std::string> str;
+} LazyOp;
+
+static LazyOp parse_op(SEXP x){
+  LazyOp op;
+  op.name = CHAR(STRING_ELT(VECTOR_ELT(x, 0), 0));
+  for(int i = 1; i < Rf_length(x); i++){
+    SEXP arg = VECTOR_ELT(x, i);
+    if(Rf_isString(arg)){
+      op.str.push_back(Rf_length(arg) ? CHAR(STRING_ELT(arg, 0)) : "");
+    } else {
+      op.num.push_back(Rf_length(arg) ? Rf_asReal(arg) : NA_REAL);
+    }
+  }
+  return op;
+}
+
+static bool is_right_angle(double degrees){
+  return std::fmod(degrees, 90.0) == 0;
+}
+
+/* Merges 'next' into 'prev' if the combination is exact. If the two cancel
+ * out, 'prev' is turned into a no-op such that it can be dropped. */
+static bool fuse_op(LazyOp & prev, const LazyOp & next){
+  if(prev.name != next.name)
+    return false;
+  if(prev.name == "flip" || prev.name == "flop" || prev.name == "negate"){
+    prev.name = "none";
+    return true;
+  }
+  if(prev.name == "rotate" && is_right_angle(prev.num.at(0)) && is_right_angle(next.num.at(0))){
+    prev.num.at(0) = std::fmod(prev.num.at(0) + next.num.at(0), 360.0);
+    if(prev.num.at(0) == 0)
+      prev.name = "none";
+    return true;
+  }
+  // Not fused: modulate quantizes the pixels in between, so two steps do not
+  // give the same result as a single step with the product
+  return false;
+}
+
+static void apply_op(Frame & frame, const LazyOp & op){
+  const std::string & name = op.name;
+  if(name == "none"){
+    return;
+  } else if(name == "modulate"){
+    Magick::modulateImage(op.num.at(0), op.num.at(1), op.num.at(2))(frame);
+  } else if(name == "negate"){
+#if MagickLibVersion >= 0x700
+    frame.negateChannel(Magick::ChannelType(Magick::CompositeChannels ^ Magick::AlphaChannel));
+#else
+    Magick::negateImage()(frame);
+#endif
+  } else if(name == "contrast"){
+    Magick::contrastImage(op.num.at(0))(frame);
+  } else if(name == "colorize"){
+    Magick::colorizeImage(op.num.at(0), Color(op.str.at(0).c_str()))(frame);
+  } else if(name == "blur"){
+    Magick::blurImage(op.num.at(0), op.num.at(1))(frame);
+  } else if(name == "resize"){
+    if(op.str.at(1).length())
+      Magick::filterTypeImage(Filter(op.str.at(1).c_str()))(frame);
+    Magick::resizeImage(Geom(op.str.at(0).c_str()))(frame);
+  } else if(name == "scale"){
+    Magick::scaleImage(Geom(op.str.at(0).c_str()))(frame);
+  } else if(name == "sample"){
+    Magick::sampleImage(Geom(op.str.at(0).c_str()))(frame);
+  } else if(name == "crop"){
+    frame_crop(frame, Geom(op.str.at(0).c_str()), op.str.at(1).c_str());
+    if(op.num.at(0))
+      Magick::pageImage(Magick::Geometry())(frame);
+  } else if(name == "rotate"){
+    Magick::rotateImage(op.num.at(0))(frame);
+  } else if(name == "flip"){
+    Magick::flipImage()(frame);
+  } else if(name == "flop"){
+    Magick::flopImage()(frame);
+  } else {
+    throw std::runtime_error("Unsupported lazy operation: " + name);
+  }
+}
+
+static FrameCost op_cost(const LazyOp & op){
+  if(op.name == "blur")
+    return COST_HEAVY;
+  if(op.name == "flip" || op.name == "flop" || op.name == "negate" || op.name == "crop" ||
+     op.name == "sample" || op.name == "scale" || op.name == "colorize" || op.name == "none")
+    return COST_LIGHT;
+  return COST_MEDIUM;
+}
+
+// [[Rcpp::export]]
+XPtrImage magick_image_lazy_eval(XPtrImage image){
+  SEXP ops = Rf_getAttrib(image, Rf_install("ops"));
+  std::vector<LazyOp> plan;
+  for(int i = 0; i < Rf_length(ops); i++){
+    LazyOp op = parse_op(VECTOR_ELT(ops, i));
+    if(plan.size() && fuse_op(plan.back(), op)){
+      if(plan.back().name == "none")
+        plan.pop_back();
+    } else {
+      plan.push_back(op);
+    }
+  }
+  // Evaluate on a copy such that a failing step leaves the image unchanged
+  FrameCost cost = COST_LIGHT;
+  for(size_t j = 0; j < plan.size(); j++)
+    cost = std::max(cost, op_cost(plan.at(j)));
+  Image frames(*image);
+  parallel_for_each(frames.begin(), frames.end(), [&](Frame & frame){
+    for(size_t j = 0; j < plan.size(); j++)
+      apply_op(frame, plan.at(j));
+  }, cost);
+  image->swap(frames);
+  image.attr("ops") = R_NilValue;
+  return image;
+}
@@ -0,0 +1,78 @@
+/* Resource limits that can be changed for the duration of a call, see
+ * with_magick_limits() in R. Most limits map directly to ImageMagick resources.
+ * The ImageMagick time resource cannot be used for this because it counts from
+ * the start of the process, so instead we keep a deadline which is checked by
+ * a progress monitor on images that are read, and after each operation.
+ */
+
+#include "magick_types.h"
+#include <chrono>
+#include <limits>
+
+typedef std::chrono::steady_clock::time_point Deadline;
+static bool has_deadline = false;
+static Deadline deadline;
+
+static bool deadline_passed(){
+  return has_deadline && std::chrono::steady_clock::now() > deadline;
+}
+
+// Returning false makes ImageMagick abort the current read or operation
+static MagickCore::MagickBooleanType time_monitor(const char *, const MagickCore::MagickOffsetType,
+                                                  const MagickCore::MagickSizeType, void *){
+  return deadline_passed() ? Magick::MagickFalse : Magick::MagickTrue;
+}
+
+void set_time_monitor(MagickCore::ImageInfo * info){
+  MagickCore::SetImageInfoProgressMonitor(info, time_monitor, NULL);
+}
+
+void check_time_limit(){
+  if(deadline_passed())
+    throw std::runtime_error("Time limit exceeded");
+}
+
+static ssize_t ParseResource(const char * str){
+  return MagickCore::ParseCommandOption(MagickCore::MagickResourceOptions, Magick::MagickFalse, str);
+}
+
+static MagickCore::ResourceType Resource(const char * str){
+  ssize_t val = ParseResource(str);
+  if(val < 0)
+    throw std::runtime_error(std::string("Resource is not supported by this version of ImageMagick: ") + str);
+  return (MagickCore::ResourceType) val;
+}
+
+// Older versions of ImageMagick do not have all resources, such as listlength
+// [[Rcpp::export]]
+bool magick_limit_exists(std::string name){
+  return name == "time" || ParseResource(name.c_str()) >= 0;
+}
+
+// [[Rcpp::export]]
+double magick_limit_get(std::string name){
+  if(name == "time"){
+    if(!has_deadline)
+      return R_PosInf;
+    return std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+  }
+  MagickCore::MagickSizeType value = MagickCore::GetMagickResourceLimit(Resource(name.c_str()));
+  return value == MagickCore::MagickResourceInfinity ? R_PosInf : (double) value;
+}
+
+// [[Rcpp::export]]
+void magick_limit_set(std::string name, std::string value){
+  bool unlimited = value == "unlimited" || value == "Inf";
+  if(name == "time"){
+    has_deadline = !unlimited;
+    if(has_deadline)
+      deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(std::max(0.0, atof(value.c_str()))));
+    return;
+  }
+  MagickCore::ResourceType type = Resource(name.c_str());
+  MagickCore::MagickSizeType limit = unlimited ? MagickCore::MagickResourceInfinity :
+    MagickCore::StringToMagickSizeType(value.c_str(), 100.0);
+  if(!MagickCore::SetMagickResourceLimit(type, limit))
+    throw std::runtime_error("Failed to set " + name + " limit to " + value + " (not allowed by policy?)");
+}
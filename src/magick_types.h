@@ -2,6 +2,7 @@
 #include <Rcpp.h>
 #include <Magick++.h>
 #include <list>
+#include <functional>
 
 typedef Magick::Image Frame;
 typedef std::vector<Frame> Image;
@@ -13,9 +14,15 @@ void finalize_image(Image *image);
 typedef Rcpp::XPtr<Image, Rcpp::PreserveStorage, finalize_image, false> XPtrImage;
 typedef Image::iterator Iter;
 
+// Reads the frames of a file in batches (edit.cpp)
+class FrameStream;
+void finalize_stream(FrameStream *stream);
+typedef Rcpp::XPtr<FrameStream, Rcpp::PreserveStorage, finalize_stream, false> XPtrStream;
+
 XPtrImage create ();
 XPtrImage create (int len);
 XPtrImage copy (XPtrImage image);
+XPtrImage modify (XPtrImage image);
 
 // Repage was introduced in 6.9.0-7 https://github.com/ImageMagick/ImageMagick/commit/919cb01
 #if MagickLibVersion >= 0x691
@@ -80,3 +87,20 @@ Magick::myFilterType Filter(const char * str);
 Magick::ChannelType Channel(const char * str);
 Magick::GravityType Gravity(const char * str);
 Magick::VirtualPixelMethod VirtualPixelValue(const char* str);
+
+// Per-frame operations shared between eager and lazy pipelines
+void frame_crop(Frame & frame, Magick::Geometry region, const char * gravity);
+
+// Applies a function to each frame using multiple threads (parallel.cpp)
+// The cost is the relative amount of work per pixel of the operation.
+typedef std::function<void (Frame &)> FrameFun;
+enum FrameCost { COST_LIGHT = 1, COST_MEDIUM = 4, COST_HEAVY = 16 };
+void parallel_for_each(Iter begin, Iter end, FrameFun fun, FrameCost cost = COST_MEDIUM);
+void parallel_for(size_t len, std::function<void (size_t)> fun);
+
+// Per-call time limit (limits.cpp)
+void set_time_monitor(MagickCore::ImageInfo * info);
+void check_time_limit();
+
+// Cache view for writing pixels from a worker thread (pixels.cpp)
+MagickCore::CacheView * acquire_authentic_view(MagickCore::Image * image, MagickCore::ExceptionInfo * exception);
@@ -0,0 +1,148 @@
+/* Frame-level parallelism for vectorized operations.
+ * ImageMagick itself parallelizes most operations over the rows of a single
+ * frame, which does not scale well for sequences of many small frames such as
+ * animations, video stills or tiles. Here the frames can be distributed over a
+ * number of worker threads instead, and the ImageMagick thread limit is lowered
+ * for the duration of the call such that the total number of threads stays
+ * within the configured limit. Workers take the next unprocessed frame from a
+ * shared counter, so one expensive frame does not hold up the others.
+ *
+ * The function that is applied to the frames must not call the R API.
+ */
+
+#include "magick_types.h"
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <exception>
+
+/* Amount of work (pixels times cost) below which it does not pay off to give a
+ * frame an additional ImageMagick thread. Can be tuned with magick_calibrate(). */
+static double grain = 1 << 18;
+
+static size_t get_thread_limit(){
+#if MagickLibVersion >= 0x689
+  return Magick::ResourceLimits::thread();
+#else
+  return 1;
+#endif
+}
+
+static void set_thread_limit(size_t n){
+#if MagickLibVersion >= 0x689
+  Magick::ResourceLimits::thread(n);
+#endif
+}
+
+/* Temporarily lowers the number of threads used by ImageMagick per operation */
+class ThreadLimit {
+  size_t old;
+public:
+  ThreadLimit(size_t n) : old(get_thread_limit()) {
+    set_thread_limit(n);
+  }
+  ~ThreadLimit(){
+    set_thread_limit(old);
+  }
+};
+
+/* Number of frames to process concurrently: large frames get all threads for
+ * pixel-level parallelism, small frames get one thread each, and in between
+ * the threads are divided such that each frame has enough work per thread. */
+static size_t frame_workers(Iter begin, Iter end, FrameCost cost, size_t threads){
+  double area = 0;
+  for(Iter it = begin; it != end; ++it)
+    area = std::max(area, (double) it->columns() * it->rows());
+  double per_frame = std::min((double) threads, std::max(1.0, area * cost / grain));
+  return std::min((size_t) (end - begin), (size_t) (threads / per_frame));
+}
+
+/* Runs fun(0) ... fun(len - 1) on the given number of threads. An exception
+ * stops the remaining tasks and is rethrown on the calling thread. */
+static void run_workers(size_t len, size_t workers, std::function<void (size_t)> fun){
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+  std::exception_ptr error;
+  std::mutex lock;
+  auto worker = [&](){
+    size_t i;
+    while(!failed && (i = next++) < len){
+      try {
+        fun(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(lock);
+        if(!failed.exchange(true))
+          error = std::current_exception();
+      }
+    }
+  };
+
+  // The calling thread is one of the workers
+  std::vector<std::thread> pool;
+  try {
+    for(size_t i = 1; i < workers; i++)
+      pool.push_back(std::thread(worker));
+  } catch (...) {
+    // Could not start another thread: continue with what we have
+  }
+  worker();
+  for(size_t i = 0; i < pool.size(); i++)
+    pool[i].join();
+  check_time_limit();
+  if(error)
+    std::rethrow_exception(error);
+}
+
+void parallel_for_each(Iter begin, Iter end, FrameFun fun, FrameCost cost){
+  size_t len = end - begin;
+  size_t threads = get_thread_limit();
+  size_t workers = threads > 1 && len > 1 ? frame_workers(begin, end, cost, threads) : 1;
+  if(workers < 2){
+    std::for_each(begin, end, fun);
+    check_time_limit();
+    return;
+  }
+  ThreadLimit limit(std::max<size_t>(1, threads / workers));
+  run_workers(len, workers, [&](size_t i){
+    fun(*(begin + i));
+  });
+}
+
+/* For tasks that do not operate on existing frames, such as reading files. Each
+ * task is assumed to have enough work for a thread of its own. */
+void parallel_for(size_t len, std::function<void (size_t)> fun){
+  size_t threads = get_thread_limit();
+  size_t workers = std::min(len, threads);
+  ThreadLimit limit(std::max<size_t>(1, threads / std::max<size_t>(1, workers)));
+  run_workers(len, workers, fun);
+}
+
+/* Short benchmark to tune the grain to the speed of this machine: an additional
+ * thread should get at least 50 times the work it takes to start a thread. */
+// [[Rcpp::export]]
+Rcpp::List magick_calibrate_internal(){
+  typedef std::chrono::steady_clock clock;
+  const int n = 16;
+  clock::time_point start = clock::now();
+  for(int i = 0; i < n; i++)
+    std::thread([](){}).join();
+  double spawn = std::chrono::duration<double>(clock::now() - start).count() / n;
+
+  Frame frame(Magick::Geometry(256, 256), Magick::Color("gray50"));
+  frame.addNoise(Magick::GaussianNoise);
+  start = clock::now();
+  {
+    ThreadLimit limit(1);
+    Magick::blurImage(1, 0.5)(frame);
+  }
+  // Time per pixel per unit of cost, where the blur is scheduled as COST_HEAVY
+  double pixel = std::chrono::duration<double>(clock::now() - start).count() / (256.0 * 256 * COST_HEAVY);
+  if(pixel > 0)
+    grain = std::max(16384.0, 50 * spawn / pixel);
+  return Rcpp::List::create(
+    Rcpp::_["grain"] = grain,
+    Rcpp::_["spawn"] = spawn,
+    Rcpp::_["pixel"] = pixel
+  );
+}
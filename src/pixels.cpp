@@ -0,0 +1,459 @@
+/* Reading and writing pixels and patches without exporting the full bitmap.
+ * Pixels are accessed through ImageMagick cache views, one per task, such that
+ * the work can be divided over multiple threads. Cache views honor the virtual
+ * pixel method of the image for coordinates outside of the frame.
+ */
+
+#include "magick_types.h"
+
+#if MagickLibVersion >= 0x700
+#define myInterpolateOptions MagickPixelInterpolateOptions
+typedef MagickCore::PixelInterpolateMethod InterpolateMethod;
+typedef MagickCore::PixelInfo PixelValue;
+#else
+#define myInterpolateOptions MagickInterpolateOptions
+typedef MagickCore::InterpolatePixelMethod InterpolateMethod;
+typedef MagickCore::MagickPixelPacket PixelValue;
+#endif
+
+// Number of points or pixels per task
+#define PIXEL_CHUNK 16384
+
+enum PixelChannel { CH_RED, CH_GREEN, CH_BLUE, CH_BLACK, CH_ALPHA };
+
+static InterpolateMethod Interpolate(const char * str){
+  ssize_t val = MagickCore::ParseCommandOption(
+    MagickCore::myInterpolateOptions, Magick::MagickFalse, str);
+  if(val < 0)
+    throw std::runtime_error(std::string("Invalid InterpolateMethod value: ") + str);
+  return (InterpolateMethod) val;
+}
+
+static MagickCore::CacheView * acquire_view(const MagickCore::Image * image, MagickCore::ExceptionInfo * exception){
+#if MagickLibVersion >= 0x690
+  return MagickCore::AcquireVirtualCacheView(image, exception);
+#else
+  return MagickCore::AcquireCacheView(image);
+#endif
+}
+
+static double channel_value(const PixelValue & pixel, PixelChannel channel){
+  switch(channel){
+    case CH_RED: return pixel.red;
+    case CH_GREEN: return pixel.green;
+    case CH_BLUE: return pixel.blue;
+#if MagickLibVersion >= 0x700
+    case CH_BLACK: return pixel.black;
+    case CH_ALPHA: return pixel.alpha;
+#else
+    case CH_BLACK: return pixel.index;
+    case CH_ALPHA: return QuantumRange - pixel.opacity;
+#endif
+  }
+  return NA_REAL;
+}
+
+/* Interpolates the pixel values at points from ... to-1 and stores them in the
+ * columns of 'out', scaled to the range 0-1. Runs on a worker thread. */
+static void sample_points(const MagickCore::Image * image, InterpolateMethod method, const double * x,
+                          const double * y, size_t from, size_t to, const std::vector<PixelChannel> & channels,
+                          double * out, size_t n){
+  MagickCore::ExceptionInfo * exception = MagickCore::AcquireExceptionInfo();
+  MagickCore::CacheView * view = acquire_view(image, exception);
+  PixelValue pixel;
+#if MagickLibVersion >= 0x700
+  MagickCore::GetPixelInfo(image, &pixel);
+#else
+  MagickCore::GetMagickPixelPacket(image, &pixel);
+#endif
+  for(size_t i = from; i < to; i++){
+    bool ok = !ISNAN(x[i]) && !ISNAN(y[i]);
+#if MagickLibVersion >= 0x700
+    ok = ok && MagickCore::InterpolatePixelInfo(image, view, method, x[i], y[i], &pixel, exception);
+#else
+    ok = ok && MagickCore::InterpolateMagickPixelPacket(image, view, method, x[i], y[i], &pixel, exception);
+#endif
+    for(size_t c = 0; c < channels.size(); c++)
+      out[i + c * n] = ok ? channel_value(pixel, channels[c]) / QuantumRange : NA_REAL;
+  }
+  MagickCore::DestroyCacheView(view);
+  MagickCore::DestroyExceptionInfo(exception);
+}
+
+// [[Rcpp::export]]
+Rcpp::NumericMatrix magick_image_pixel_at(XPtrImage input, Rcpp::NumericVector x, Rcpp::NumericVector y,
+                                          size_t frame, const char * interpolate){
+  if(frame < 1 || frame > input->size())
+    throw std::runtime_error("Frame index out of range");
+  if(x.size() != y.size())
+    throw std::runtime_error("Coordinates x and y must have the same length");
+  Frame image = input->at(frame - 1);
+  InterpolateMethod method = Interpolate(interpolate);
+  std::vector<PixelChannel> channels;
+  Rcpp::CharacterVector names;
+  Magick::ColorspaceType space = image.colorSpace();
+  if(space == Magick::GRAYColorspace){
+    channels.push_back(CH_RED);
+    names.push_back("gray");
+  } else if(space == Magick::CMYKColorspace){
+    channels = {CH_RED, CH_GREEN, CH_BLUE, CH_BLACK};
+    names = Rcpp::CharacterVector::create("cyan", "magenta", "yellow", "black");
+  } else {
+    channels = {CH_RED, CH_GREEN, CH_BLUE};
+    names = Rcpp::CharacterVector::create("red", "green", "blue");
+  }
+  if(image.hasMatte()){
+    channels.push_back(CH_ALPHA);
+    names.push_back("alpha");
+  }
+  size_t n = x.size();
+  Rcpp::NumericMatrix out(n, channels.size());
+  const double * px = x.begin();
+  const double * py = y.begin();
+  double * res = out.begin();
+  const MagickCore::Image * ptr = image.constImage();
+  parallel_for((n + PIXEL_CHUNK - 1) / PIXEL_CHUNK, [&](size_t i){
+    sample_points(ptr, method, px, py, i * PIXEL_CHUNK, std::min(n, (i + 1) * PIXEL_CHUNK), channels, res, n);
+  });
+  Rcpp::colnames(out) = names;
+  return out;
+}
+
+/* A color in quantum values with a non-inverted alpha, on both IM6 and IM7 */
+typedef struct {
+  double red, green, blue, alpha;
+} PixelColor;
+
+static PixelColor pixel_color(const char * str){
+  Magick::Color col = Color(str);
+  PixelColor out;
+  out.red = col.myRedQ();
+  out.green = col.myGreenQ();
+  out.blue = col.myBlueQ();
+#if MagickLibVersion >= 0x700
+  out.alpha = col.myAlphaQ();
+#else //NOTE: alpha scale is reverse on IM6
+  out.alpha = QuantumRange - col.myAlphaQ();
+#endif
+  return out;
+}
+
+MagickCore::CacheView * acquire_authentic_view(MagickCore::Image * image, MagickCore::ExceptionInfo * exception){
+#if MagickLibVersion >= 0x690
+  return MagickCore::AcquireAuthenticCacheView(image, exception);
+#else
+  return MagickCore::AcquireCacheView(image);
+#endif
+}
+
+/* Porter-Duff "over" of a color onto a pixel. Both have straight rather than
+ * premultiplied color values, so the colors are weighted by their alpha. */
+static inline PixelColor over(const PixelColor & src, const PixelColor & dst){
+  double as = src.alpha / QuantumRange;
+  double ad = dst.alpha / QuantumRange;
+  double ao = as + ad * (1 - as);
+  PixelColor out = {0, 0, 0, ao * QuantumRange};
+  if(ao > 0){
+    out.red = (src.red * as + dst.red * ad * (1 - as)) / ao;
+    out.green = (src.green * as + dst.green * ad * (1 - as)) / ao;
+    out.blue = (src.blue * as + dst.blue * ad * (1 - as)) / ao;
+  }
+  return out;
+}
+
+/* Writes a horizontal run of pixels of a single color to a cache view. With
+ * blending the color is composited over the existing pixels, otherwise the
+ * pixels are replaced including their alpha. */
+static void write_span(MagickCore::Image * image, MagickCore::CacheView * view, ssize_t x, ssize_t y, size_t len,
+                       const PixelColor & col, bool blend, bool matte, MagickCore::ExceptionInfo * exception){
+  PixelColor out = col;
+#if MagickLibVersion >= 0x700
+  MagickCore::Quantum * q = MagickCore::GetCacheViewAuthenticPixels(view, x, y, len, 1, exception);
+  if(q == NULL)
+    return;
+  for(size_t i = 0; i < len; i++){
+    if(blend){
+      PixelColor dst = {(double) MagickCore::GetPixelRed(image, q), (double) MagickCore::GetPixelGreen(image, q),
+                        (double) MagickCore::GetPixelBlue(image, q),
+                        matte ? (double) MagickCore::GetPixelAlpha(image, q) : (double) QuantumRange};
+      out = over(col, dst);
+    }
+    MagickCore::SetPixelRed(image, MagickCore::ClampToQuantum(out.red), q);
+    MagickCore::SetPixelGreen(image, MagickCore::ClampToQuantum(out.green), q);
+    MagickCore::SetPixelBlue(image, MagickCore::ClampToQuantum(out.blue), q);
+    if(matte)
+      MagickCore::SetPixelAlpha(image, MagickCore::ClampToQuantum(out.alpha), q);
+    q += MagickCore::GetPixelChannels(image);
+  }
+#else
+  MagickCore::PixelPacket * q = MagickCore::GetCacheViewAuthenticPixels(view, x, y, len, 1, exception);
+  if(q == NULL)
+    return;
+  for(size_t i = 0; i < len; i++){
+    if(blend){
+      PixelColor dst = {(double) GetPixelRed(q), (double) GetPixelGreen(q), (double) GetPixelBlue(q),
+                        matte ? (double) GetPixelAlpha(q) : (double) QuantumRange};
+      out = over(col, dst);
+    }
+    SetPixelRed(q, MagickCore::ClampToQuantum(out.red));
+    SetPixelGreen(q, MagickCore::ClampToQuantum(out.green));
+    SetPixelBlue(q, MagickCore::ClampToQuantum(out.blue));
+    if(matte)
+      SetPixelAlpha(q, MagickCore::ClampToQuantum(out.alpha));
+    q++;
+  }
+#endif
+  MagickCore::SyncCacheViewAuthenticPixels(view, exception);
+}
+
+/* Paints horizontal runs of pixels: span i starts at (x[i], y[i]) and covers
+ * len[i] pixels with color colors[col[i]]. Spans are clipped to the frame. The
+ * rows of the frame are divided into bands that are painted in parallel, where
+ * spans within a band are painted in input order, so overlapping spans give the
+ * same result regardless of the number of threads. */
+// [[Rcpp::export]]
+XPtrImage magick_image_set_spans(XPtrImage input, Rcpp::IntegerVector x, Rcpp::IntegerVector y,
+                                 Rcpp::IntegerVector len, Rcpp::CharacterVector colors,
+                                 Rcpp::IntegerVector col, size_t frame, bool blend){
+  size_t n = x.size();
+  if(y.size() != x.size() || len.size() != x.size() || col.size() != x.size())
+    throw std::runtime_error("Coordinates, lengths and colors must have the same length");
+  std::vector<PixelColor> palette;
+  bool opaque = true;
+  for(int i = 0; i < colors.size(); i++){
+    palette.push_back(pixel_color(colors.at(i)));
+    opaque = opaque && palette.back().alpha >= QuantumRange;
+  }
+  XPtrImage output = modify(input);
+  if(frame < 1 || frame > output->size())
+    throw std::runtime_error("Frame index out of range");
+  Frame & target = output->at(frame - 1);
+  Magick::ColorspaceType space = target.colorSpace();
+  if(space == Magick::GRAYColorspace)
+    target.colorSpace(Magick::sRGBColorspace);
+  else if(space != Magick::sRGBColorspace && space != Magick::RGBColorspace)
+    throw std::runtime_error("Pixels can only be set on RGB or gray frames");
+  if(!blend && !opaque && !target.hasMatte())
+    Magick::myMatteImage(true)(target);
+  target.modifyImage();
+  ssize_t width = target.columns();
+  ssize_t height = target.rows();
+
+  // Clip spans and assign them to bands of rows
+  size_t band_rows = std::max<ssize_t>(1, height / 64);
+  std::vector<std::vector<size_t> > bands((height + band_rows - 1) / band_rows);
+  std::vector<ssize_t> from(n), to(n);
+  for(size_t i = 0; i < n; i++){
+    if(x[i] == NA_INTEGER || y[i] == NA_INTEGER || len[i] == NA_INTEGER || col[i] == NA_INTEGER)
+      continue;
+    if(col[i] < 1 || col[i] > (int) palette.size())
+      throw std::runtime_error("Invalid color index");
+    from[i] = std::max(0, x[i]);
+    to[i] = std::min<ssize_t>(width, (ssize_t) x[i] + len[i]);
+    if(y[i] < 0 || y[i] >= height || from[i] >= to[i])
+      continue;
+    bands[y[i] / band_rows].push_back(i);
+  }
+  MagickCore::Image * image = target.image();
+  bool matte = target.hasMatte();
+  parallel_for(bands.size(), [&](size_t b){
+    MagickCore::ExceptionInfo * exception = MagickCore::AcquireExceptionInfo();
+    MagickCore::CacheView * view = acquire_authentic_view(image, exception);
+    for(size_t k = 0; k < bands[b].size(); k++){
+      size_t i = bands[b][k];
+      write_span(image, view, from[i], y[i], to[i] - from[i], palette[col[i] - 1], blend, matte, exception);
+    }
+    MagickCore::DestroyCacheView(view);
+    MagickCore::DestroyExceptionInfo(exception);
+  });
+  return output;
+}
+
+/* Reads a rectangle of pixels through a virtual cache view into an interleaved
+ * buffer with the channels of the map (R, G, B, A or I for intensity). Pixels
+ * outside of the frame are filled according to the virtual pixel method. */
+static bool read_region(const MagickCore::Image * image, MagickCore::CacheView * view, ssize_t x, ssize_t y,
+                        size_t width, size_t height, const std::string & map, MagickCore::Quantum * out,
+                        MagickCore::ExceptionInfo * exception){
+#if MagickLibVersion >= 0x700
+  const MagickCore::Quantum * p = MagickCore::GetCacheViewVirtualPixels(view, x, y, width, height, exception);
+  if(p == NULL)
+    return false;
+  for(size_t i = 0; i < width * height; i++){
+    for(size_t c = 0; c < map.length(); c++){
+      switch(map[c]){
+        case 'R': *out++ = MagickCore::GetPixelRed(image, p); break;
+        case 'G': *out++ = MagickCore::GetPixelGreen(image, p); break;
+        case 'B': *out++ = MagickCore::GetPixelBlue(image, p); break;
+        case 'A': *out++ = MagickCore::GetPixelAlpha(image, p); break;
+        default: *out++ = MagickCore::ClampToQuantum(MagickCore::GetPixelIntensity(image, p));
+      }
+    }
+    p += MagickCore::GetPixelChannels(image);
+  }
+#else
+  const MagickCore::PixelPacket * p = MagickCore::GetCacheViewVirtualPixels(view, x, y, width, height, exception);
+  if(p == NULL)
+    return false;
+  for(size_t i = 0; i < width * height; i++, p++){
+    for(size_t c = 0; c < map.length(); c++){
+      switch(map[c]){
+        case 'R': *out++ = GetPixelRed(p); break;
+        case 'G': *out++ = GetPixelGreen(p); break;
+        case 'B': *out++ = GetPixelBlue(p); break;
+        case 'A': *out++ = GetPixelAlpha(p); break;
+        default: *out++ = MagickCore::ClampToQuantum(MagickCore::GetPixelIntensity(image, p));
+      }
+    }
+  }
+#endif
+  return true;
+}
+
+/* Fraction of the pixels of a patch that are within 'fuzz' of the background
+ * color on each channel, with fuzz and color in quantum values. */
+static double background_fraction(const MagickCore::Quantum * buf, size_t pixels, const std::string & map,
+                                  const PixelColor & bg, double fuzz){
+  size_t count = 0;
+  for(size_t i = 0; i < pixels; i++){
+    bool match = true;
+    for(size_t c = 0; c < map.length(); c++, buf++){
+      double ref = map[c] == 'R' || map[c] == 'I' ? bg.red : map[c] == 'G' ? bg.green :
+        map[c] == 'B' ? bg.blue : bg.alpha;
+      match = match && std::abs((double) *buf - ref) <= fuzz;
+    }
+    count += match;
+  }
+  return (double) count / pixels;
+}
+
+typedef struct {
+  size_t frame;
+  ssize_t x, y;
+} PatchPos;
+
+/* Extracts patches of a fixed size at a fixed stride from all frames, reading
+ * straight from the pixel cache of the source frames in parallel. Patches may
+ * be skipped if they are mostly background. The result is either a raw array
+ * with a patch in each 3D slice, or an image with a frame per patch. */
+// [[Rcpp::export]]
+SEXP magick_image_patches(XPtrImage input, std::string size, std::string stride, bool padding,
+                          std::string channels, Rcpp::CharacterVector background, double fuzz_percent,
+                          double max_background, bool array){
+  Magick::Geometry geom = Geom(size.c_str());
+  Magick::Geometry step = stride.length() ? Geom(stride.c_str()) : geom;
+  size_t width = geom.width(), height = geom.height();
+  size_t dx = step.width() ? step.width() : width;
+  size_t dy = step.height() ? step.height() : dx;
+  if(!width || !height)
+    throw std::runtime_error("Patch size must have both a width and height, for example 256x256");
+  std::transform(channels.begin(), channels.end(), channels.begin(), ::toupper);
+  std::string map = channels == "GRAY" ? "I" : channels;
+  if(map != "I" && map != "RGB" && map != "RGBA")
+    throw std::runtime_error("Patch channels must be one of gray, rgb or rgba");
+  bool skip = background.size() > 0;
+  PixelColor bg = skip ? pixel_color(background.at(0)) : PixelColor();
+  double fuzz = fuzz_percent / 100 * QuantumRange;
+
+  // Frames in other colorspaces are read as sRGB
+  Image frames(*input);
+  std::vector<PatchPos> pos;
+  for(size_t i = 0; i < frames.size(); i++){
+    Magick::ColorspaceType space = frames[i].colorSpace();
+    if(space != Magick::sRGBColorspace && space != Magick::RGBColorspace && space != Magick::GRAYColorspace)
+      frames[i].colorSpace(Magick::sRGBColorspace);
+    ssize_t cols = frames[i].columns(), rows = frames[i].rows();
+    ssize_t xmax = padding ? cols - 1 : cols - (ssize_t) width;
+    ssize_t ymax = padding ? rows - 1 : rows - (ssize_t) height;
+    for(ssize_t y = 0; y <= ymax; y += dy)
+      for(ssize_t x = 0; x <= xmax; x += dx)
+        pos.push_back({i, x, y});
+  }
+
+  // Reads a patch on a worker thread, each task uses its own cache views
+  size_t pixels = width * height;
+  size_t len = pixels * map.length();
+  size_t chunks = (pos.size() + 63) / 64;
+  auto read_chunk = [&](size_t k, std::function<void (size_t, const MagickCore::Quantum *)> fun){
+    MagickCore::ExceptionInfo * exception = MagickCore::AcquireExceptionInfo();
+    std::vector<MagickCore::CacheView *> views(frames.size(), (MagickCore::CacheView *) NULL);
+    std::vector<MagickCore::Quantum> buf(len);
+    bool ok = true;
+    for(size_t i = k * 64; ok && i < std::min(pos.size(), (k + 1) * 64); i++){
+      const MagickCore::Image * image = frames[pos[i].frame].constImage();
+      MagickCore::CacheView *& view = views[pos[i].frame];
+      if(view == NULL)
+        view = acquire_view(image, exception);
+      ok = read_region(image, view, pos[i].x, pos[i].y, width, height, map, buf.data(), exception);
+      if(ok)
+        fun(i, buf.data());
+    }
+    for(size_t j = 0; j < views.size(); j++)
+      if(views[j])
+        MagickCore::DestroyCacheView(views[j]);
+    MagickCore::DestroyExceptionInfo(exception);
+    if(!ok)
+      throw std::runtime_error("Failed to read pixels of patch");
+  };
+
+  std::vector<size_t> keep;
+  if(skip){
+    std::vector<char> mask(pos.size());
+    parallel_for(chunks, [&](size_t k){
+      read_chunk(k, [&](size_t i, const MagickCore::Quantum * buf){
+        mask[i] = background_fraction(buf, pixels, map, bg, fuzz) <= max_background;
+      });
+    });
+    for(size_t i = 0; i < pos.size(); i++)
+      if(mask[i])
+        keep.push_back(i);
+  } else {
+    for(size_t i = 0; i < pos.size(); i++)
+      keep.push_back(i);
+  }
+  std::vector<size_t> slot(pos.size(), (size_t) -1);
+  for(size_t j = 0; j < keep.size(); j++)
+    slot[keep[j]] = j;
+
+  Rcpp::IntegerVector pframe(keep.size()), px(keep.size()), py(keep.size());
+  for(size_t j = 0; j < keep.size(); j++){
+    pframe[j] = pos[keep[j]].frame + 1;
+    px[j] = pos[keep[j]].x;
+    py[j] = pos[keep[j]].y;
+  }
+  Rcpp::DataFrame index = Rcpp::DataFrame::create(Rcpp::_["frame"] = pframe, Rcpp::_["x"] = px, Rcpp::_["y"] = py);
+
+  if(array){
+    Rcpp::RawVector out(keep.size() * len);
+    unsigned char * data = out.begin();
+    parallel_for(chunks, [&](size_t k){
+      read_chunk(k, [&](size_t i, const MagickCore::Quantum * buf){
+        if(slot[i] == (size_t) -1)
+          return;
+        unsigned char * dest = data + slot[i] * len;
+        for(size_t j = 0; j < len; j++)
+          dest[j] = MagickCore::ScaleQuantumToChar(buf[j]);
+      });
+    });
+    out.attr("dim") = Rcpp::IntegerVector::create(map.length(), width, height, keep.size());
+    out.attr("patches") = index;
+    return out;
+  }
+  Image output(keep.size());
+  parallel_for(chunks, [&](size_t k){
+    read_chunk(k, [&](size_t i, const MagickCore::Quantum * buf){
+      if(slot[i] == (size_t) -1)
+        return;
+      Frame patch(width, height, map, Magick::QuantumPixel, buf);
+      patch.page(Magick::Geometry(0, 0, pos[i].x, pos[i].y));
+      std::string format = frames[pos[i].frame].magick();
+      if(format.length())
+        patch.magick(format);
+      output[slot[i]] = patch;
+    });
+  });
+  XPtrImage image = create();
+  image->swap(output);
+  image.attr("patches") = index;
+  return image;
+}
@@ -155,38 +155,39 @@ Magick::Point Point(const char * str){
 
 // [[Rcpp::export]]
 XPtrImage magick_image_noise( XPtrImage input, const char * noisetype){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::addNoiseImage(Noise(noisetype)));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::addNoiseImage(Noise(noisetype)), COST_HEAVY);
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_blur( XPtrImage input, const double radius = 1, const double sigma = 0.5){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::blurImage(radius, sigma));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::blurImage(radius, sigma), COST_HEAVY);
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_motion_blur( XPtrImage input, const double radius = 1, const double sigma = 0.5, const double angle = 0.0){
-  XPtrImage output = copy(input);
-  for(size_t i = 0; i < output->size(); i++)
-    output->at(i).motionBlur(radius, sigma, angle);
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), [=](Frame & frame){
+    frame.motionBlur(radius, sigma, angle);
+  }, COST_HEAVY);
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_charcoal( XPtrImage input, const double radius = 1, const double sigma = 0.5){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
 #if MagickLibVersion >= 0x700
-  for(size_t i = 0; i < output->size(); i++){
-    MagickCore::Image *im = output->at(i).image();
+  parallel_for_each(output->begin(), output->end(), [=](Frame & frame){
+    MagickCore::Image *im = frame.image();
     Magick::ChannelType old = MagickCore::SetImageChannelMask(im, Magick::ChannelType(Magick::CompositeChannels ^ Magick::AlphaChannel));
-    output->at(i).charcoal(radius, sigma);
+    frame.charcoal(radius, sigma);
     MagickCore::SetImageChannelMask(im, old);
-  }
+  }, COST_HEAVY);
 #else
-  for_each ( output->begin(), output->end(), Magick::charcoalImage(radius, sigma));
+  parallel_for_each(output->begin(), output->end(), Magick::charcoalImage(radius, sigma), COST_HEAVY);
 #endif
   return output;
 }
@@ -194,10 +195,11 @@ XPtrImage magick_image_charcoal( XPtrImage input, const double radius = 1, const
 /* Added in f78d1802df605fe2a0bd2551f4e4a27702e12828 */
 // [[Rcpp::export]]
 XPtrImage magick_image_deskew( XPtrImage input, double treshold){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
 #if MagickLibVersion >= 0x686
-  for (Iter it = output->begin(); it != output->end(); ++it)
-    it->deskew(treshold);
+  parallel_for_each(output->begin(), output->end(), [=](Frame & frame){
+    frame.deskew(treshold);
+  }, COST_HEAVY);
 #else
   throw std::runtime_error("deskew not supported, ImageMagick too old");
 #endif
@@ -206,53 +208,55 @@ XPtrImage magick_image_deskew( XPtrImage input, double treshold){
 
 // [[Rcpp::export]]
 XPtrImage magick_image_emboss( XPtrImage input, const double radius = 1, const double sigma = 0.5){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::embossImage(radius, sigma));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::embossImage(radius, sigma), COST_HEAVY);
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_fill( XPtrImage input, const char * color, const char * point,
                              double fuzz_percent, Rcpp::CharacterVector border_color){
-  XPtrImage output = copy(input);
   double fuzz = fuzz_pct_to_abs(fuzz_percent);
+  double oldfuzz = input->size() ? input->front().colorFuzz() : 0;
+  XPtrImage output = modify(input);
   if(fuzz != 0)
     for_each ( output->begin(), output->end(), Magick::colorFuzzImage( fuzz ));
   if(border_color.size()){
-    for_each ( output->begin(), output->end(), Magick::floodFillColorImage(
-        Magick::Geometry(Geom(point)), Color(color), Color(border_color[0])));
+    parallel_for_each(output->begin(), output->end(), Magick::floodFillColorImage(
+        Magick::Geometry(Geom(point)), Color(color), Color(border_color[0])), COST_LIGHT);
   } else {
-    for_each ( output->begin(), output->end(), Magick::floodFillColorImage(
-        Magick::Geometry(Geom(point)), Color(color)));
+    parallel_for_each(output->begin(), output->end(), Magick::floodFillColorImage(
+        Magick::Geometry(Geom(point)), Color(color)), COST_LIGHT);
   }
   if(fuzz != 0)
-    for_each ( output->begin(), output->end(), Magick::colorFuzzImage(input->front().colorFuzz()));
+    for_each ( output->begin(), output->end(), Magick::colorFuzzImage(oldfuzz));
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_negate( XPtrImage input){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
 #if MagickLibVersion >= 0x700
-  for(size_t i = 0; i < output->size(); i++)
-    output->at(i).negateChannel(Magick::ChannelType(Magick::CompositeChannels ^ Magick::AlphaChannel));
+  parallel_for_each(output->begin(), output->end(), [](Frame & frame){
+    frame.negateChannel(Magick::ChannelType(Magick::CompositeChannels ^ Magick::AlphaChannel));
+  }, COST_LIGHT);
 #else
-  for_each ( output->begin(), output->end(), Magick::negateImage());
+  parallel_for_each(output->begin(), output->end(), Magick::negateImage(), COST_LIGHT);
 #endif
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_oilpaint( XPtrImage input, size_t radius){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::oilPaintImage(radius));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::oilPaintImage(radius), COST_HEAVY);
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_implode( XPtrImage input, double factor){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::implodeImage(factor));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::implodeImage(factor));
   return output;
 }
 
@@ -260,7 +264,7 @@ XPtrImage magick_image_implode( XPtrImage input, double factor){
 XPtrImage magick_image_format( XPtrImage input, Rcpp::CharacterVector format, Rcpp::CharacterVector type,
                                Rcpp::CharacterVector space, Rcpp::IntegerVector depth, Rcpp::LogicalVector antialias,
                                Rcpp::LogicalVector matte, Rcpp::CharacterVector interlace, Rcpp::RawVector profile){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   if(antialias.size()){
     for (Iter it = output->begin(); it != output->end(); ++it)
       it->strokeAntiAlias(antialias.at(0));
@@ -276,7 +280,7 @@ XPtrImage magick_image_format( XPtrImage input, Rcpp::CharacterVector format, Rc
   if(type.size())
     for_each ( output->begin(), output->end(), Magick::typeImage(Type(type.at(0))));
   if(space.size())
-    for_each ( output->begin(), output->end(), Magick::colorSpaceImage(ColorSpace(space.at(0))));
+    parallel_for_each(output->begin(), output->end(), Magick::colorSpaceImage(ColorSpace(space.at(0))));
   if(depth.size())
     for_each ( output->begin(), output->end(), Magick::depthImage(depth.at(0)));
   if(interlace.size())
@@ -289,7 +293,7 @@ XPtrImage magick_image_format( XPtrImage input, Rcpp::CharacterVector format, Rc
 
 // [[Rcpp::export]]
 XPtrImage magick_image_page( XPtrImage input, Rcpp::CharacterVector pagesize, Rcpp::CharacterVector density){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   if(pagesize.size())
     for_each (output->begin(), output->end(), Magick::pageImage(Geom(pagesize[0])));
   if(density.size())
@@ -299,14 +303,14 @@ XPtrImage magick_image_page( XPtrImage input, Rcpp::CharacterVector pagesize, Rc
 
 // [[Rcpp::export]]
 XPtrImage magick_image_repage( XPtrImage input){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   for_each (output->begin(), output->end(), Magick::pageImage(Magick::Geometry()));
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_orient( XPtrImage input, Rcpp::CharacterVector orientation){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   for(size_t i = 0; i < output->size(); i++){
     if(orientation.length()){
       output->at(i).orientation(Orientation(orientation.at(0)));
@@ -324,17 +328,17 @@ XPtrImage magick_image_orient( XPtrImage input, Rcpp::CharacterVector orientatio
 
 // [[Rcpp::export]]
 XPtrImage magick_image_despeckle( XPtrImage input, int times){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   for (int i=0; i < times; i++) {
-    for_each ( output->begin(), output->end(), Magick::despeckleImage());
+    parallel_for_each(output->begin(), output->end(), Magick::despeckleImage(), COST_HEAVY);
   }
   return output;
 }
 
 // [[Rcpp::export]]
 XPtrImage magick_image_reducenoise( XPtrImage input, const size_t radius){
-  XPtrImage output = copy(input);
-  for_each ( output->begin(), output->end(), Magick::reduceNoiseImage(radius));
+  XPtrImage output = modify(input);
+  parallel_for_each(output->begin(), output->end(), Magick::reduceNoiseImage(radius), COST_HEAVY);
   return output;
 }
 /* STL is broken for annotateImage.
@@ -348,7 +352,7 @@ XPtrImage magick_image_annotate( XPtrImage input, Rcpp::CharacterVector text, co
                                  Rcpp::CharacterVector decoration, Rcpp::CharacterVector color,
                                  Rcpp::CharacterVector strokecolor, Rcpp::IntegerVector strokewidth,
                                  Rcpp::CharacterVector boxcolor){
-  XPtrImage output = copy(input);
+  XPtrImage output = modify(input);
   typedef std::container<Magick::Drawable> drawlist;
   Magick::Geometry pos(location);
   double x = pos.xOff();
@@ -416,7 +420,7 @@ XPtrImage magick_image_compare( XPtrImage input, XPtrImage reference_image, cons
 
 // [[Rcpp::export]]
 XPtrImage magick_image_distort(XPtrImage input, std::string method, Rcpp::NumericVector values, bool bestfit){
-  XPtrImage out = copy(input);;
+  XPtrImage out = modify(input);
   for_each (out->begin(), out->end(),
             Magick::distortImage(DistortionMethod(method.c_str()), values.size(), values.begin(), bestfit));
   return out;